@@ -0,0 +1,225 @@
+#include "AssetArchive.h"
+#include "ContentHash.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+namespace
+{
+std::uint64_t alignUp(std::uint64_t v, std::uint64_t a) { return (v + a - 1) & ~(a - 1); }
+} // namespace
+
+std::uint64_t archiveNameHash(const std::string &name) { return contentHash(name.data(), name.size()); }
+
+// ============= ArchiveInputStream Implementation =============
+
+ArchiveInputStream::ArchiveInputStream(const std::uint8_t *bytes, std::size_t length)
+    : data(bytes), size(length), position(0) {}
+
+ArchiveInputStream::ArchiveInputStream(std::vector<std::uint8_t> decompressed)
+    : data(nullptr), size(decompressed.size()), position(0), inflated(std::move(decompressed))
+{
+    data = inflated.data();
+}
+
+std::optional<std::size_t> ArchiveInputStream::read(void *out, std::size_t count)
+{
+    std::size_t available = std::min(count, size - position);
+    if (available > 0)
+        std::memcpy(out, data + position, available);
+    position += available;
+    return available;
+}
+
+std::optional<std::size_t> ArchiveInputStream::seek(std::size_t newPosition)
+{
+    position = std::min(newPosition, size);
+    return position;
+}
+
+std::optional<std::size_t> ArchiveInputStream::tell() { return position; }
+
+std::optional<std::size_t> ArchiveInputStream::getSize() { return size; }
+
+// ============= AssetArchive Implementation =============
+
+AssetArchive::AssetArchive() : entries(nullptr), entryCount(0), names(nullptr), namesSize(0) {}
+
+bool AssetArchive::open(const std::string &path)
+{
+    if (!mapping.open(path))
+    {
+        std::cerr << "Cannot open asset archive " << path << "\n";
+        return false;
+    }
+
+    const std::uint8_t *base = mapping.getData();
+    std::size_t size = mapping.getSize();
+    const auto *header = reinterpret_cast<const ArchiveHeader *>(base);
+
+    bool valid = size >= sizeof(ArchiveHeader) &&
+                 std::memcmp(header->magic, ArchiveFormat::Magic, sizeof(header->magic)) == 0 &&
+                 header->version == ArchiveFormat::Version &&
+                 header->byteOrder == ArchiveFormat::ByteOrderMark &&
+                 header->entryCount <= (size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry);
+    if (valid)
+    {
+        entries = reinterpret_cast<const ArchiveEntry *>(base + sizeof(ArchiveHeader));
+        entryCount = header->entryCount;
+        std::size_t namesStart = sizeof(ArchiveHeader) + entryCount * sizeof(ArchiveEntry);
+        names = reinterpret_cast<const char *>(base + namesStart);
+        namesSize = size - namesStart;
+
+        for (std::uint32_t i = 0; i < entryCount && valid; ++i)
+        {
+            const ArchiveEntry &e = entries[i];
+            // The size of a compressed entry is allocated up front, so it
+            // must be one its stored bytes can actually decode to
+            valid = e.nameOffset <= namesSize && e.nameLength <= namesSize - e.nameOffset &&
+                    e.offset <= size && e.storedSize <= size - e.offset &&
+                    (e.compression == static_cast<std::uint32_t>(ArchiveFormat::Compression::Lz4)
+                         ? e.size <= lz4MaxDecompressedSize(e.storedSize)
+                         : e.storedSize == e.size);
+        }
+    }
+
+    if (!valid)
+    {
+        std::cerr << path << " is not a valid asset archive\n";
+        mapping.close();
+        entries = nullptr;
+        entryCount = 0;
+        return false;
+    }
+    return true;
+}
+
+const ArchiveEntry *AssetArchive::find(const std::string &name) const
+{
+    std::uint64_t hash = archiveNameHash(name);
+    const ArchiveEntry *end = entries + entryCount;
+    const ArchiveEntry *it = std::lower_bound(entries, end, hash,
+                                              [](const ArchiveEntry &e, std::uint64_t h)
+                                              { return e.nameHash < h; });
+
+    for (; it != end && it->nameHash == hash; ++it)
+    {
+        if (it->nameLength == name.size() && std::memcmp(names + it->nameOffset, name.data(), name.size()) == 0)
+            return it;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<ArchiveInputStream> AssetArchive::openStream(const std::string &name) const
+{
+    const ArchiveEntry *entry = find(name);
+    if (!entry)
+        return nullptr;
+
+    const std::uint8_t *blob = mapping.getData() + entry->offset;
+    if (entry->compression == static_cast<std::uint32_t>(ArchiveFormat::Compression::None))
+        return std::make_unique<ArchiveInputStream>(blob, static_cast<std::size_t>(entry->size));
+
+    std::vector<std::uint8_t> inflated(static_cast<std::size_t>(entry->size));
+    if (!lz4Decompress(blob, static_cast<std::size_t>(entry->storedSize), inflated.data(), inflated.size()))
+    {
+        std::cerr << "Corrupt archive entry " << name << "\n";
+        return nullptr;
+    }
+    return std::make_unique<ArchiveInputStream>(std::move(inflated));
+}
+
+// ============= AssetArchiveWriter Implementation =============
+
+void AssetArchiveWriter::add(const std::string &name, std::vector<std::uint8_t> bytes, bool allowCompression)
+{
+    Pending entry{name, {}, bytes.size(), ArchiveFormat::Compression::None};
+
+    if (allowCompression && !bytes.empty())
+    {
+        std::vector<std::uint8_t> packed;
+        lz4Compress(bytes.data(), bytes.size(), packed);
+        if (packed.size() * 10 < bytes.size() * 9)
+        {
+            entry.bytes = std::move(packed);
+            entry.compression = ArchiveFormat::Compression::Lz4;
+        }
+    }
+    if (entry.compression == ArchiveFormat::Compression::None)
+        entry.bytes = std::move(bytes);
+
+    pending.push_back(std::move(entry));
+}
+
+bool AssetArchiveWriter::writeFile(const std::string &path) const
+{
+    std::vector<const Pending *> order;
+    for (const Pending &p : pending)
+        order.push_back(&p);
+    std::sort(order.begin(), order.end(), [](const Pending *a, const Pending *b)
+              { return std::make_tuple(archiveNameHash(a->name), a->name) <
+                       std::make_tuple(archiveNameHash(b->name), b->name); });
+
+    std::vector<ArchiveEntry> index(order.size());
+    std::string nameTable;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        index[i].nameHash = archiveNameHash(order[i]->name);
+        index[i].nameOffset = static_cast<std::uint32_t>(nameTable.size());
+        index[i].nameLength = static_cast<std::uint32_t>(order[i]->name.size());
+        index[i].storedSize = order[i]->bytes.size();
+        index[i].size = order[i]->size;
+        index[i].compression = static_cast<std::uint32_t>(order[i]->compression);
+        index[i].reserved = 0;
+        nameTable += order[i]->name;
+    }
+
+    std::uint64_t offset = sizeof(ArchiveHeader) + index.size() * sizeof(ArchiveEntry) + nameTable.size();
+    for (ArchiveEntry &entry : index)
+    {
+        offset = alignUp(offset, ArchiveFormat::BlobAlignment);
+        entry.offset = offset;
+        offset += entry.storedSize;
+    }
+
+    ArchiveHeader header;
+    std::memcpy(header.magic, ArchiveFormat::Magic, sizeof(header.magic));
+    header.version = ArchiveFormat::Version;
+    header.byteOrder = ArchiveFormat::ByteOrderMark;
+    header.entryCount = static_cast<std::uint32_t>(index.size());
+
+    std::vector<std::uint8_t> out(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    if (!index.empty())
+        std::memcpy(out.data() + sizeof(header), index.data(), index.size() * sizeof(ArchiveEntry));
+    std::memcpy(out.data() + sizeof(header) + index.size() * sizeof(ArchiveEntry), nameTable.data(), nameTable.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (!order[i]->bytes.empty())
+            std::memcpy(out.data() + index[i].offset, order[i]->bytes.data(), order[i]->bytes.size());
+    }
+
+    // Write then rename, so a running game never maps a half-written archive
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file)
+        {
+            std::cerr << "Cannot write archive " << path << "\n";
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+    {
+        std::cerr << "Cannot write archive " << path << ": " << error.message() << "\n";
+        return false;
+    }
+    return true;
+}
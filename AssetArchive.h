@@ -0,0 +1,123 @@
+#pragma once
+
+#include <SFML/System/InputStream.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// Single-file asset archive:
+//
+//   ArchiveHeader
+//   ArchiveEntry[entryCount], sorted by (nameHash, name)
+//   name table (UTF-8, not terminated)
+//   blobs, each starting on a BlobAlignment boundary
+//
+// An entry is stored raw or as one LZ4 block. The archive is memory-mapped,
+// so raw entries are read in place without any copy.
+namespace ArchiveFormat
+{
+constexpr char Magic[4] = {'S', 'P', 'A', 'K'};
+constexpr std::uint32_t Version = 1;
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+constexpr std::uint32_t BlobAlignment = 64;
+
+enum class Compression : std::uint32_t
+{
+    None = 0,
+    Lz4 = 1
+};
+} // namespace ArchiveFormat
+
+struct ArchiveHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t entryCount;
+};
+
+struct ArchiveEntry
+{
+    std::uint64_t nameHash;
+    std::uint32_t nameOffset; // Into the name table
+    std::uint32_t nameLength;
+    std::uint64_t offset;     // Blob position from the start of the file
+    std::uint64_t storedSize;
+    std::uint64_t size;       // Uncompressed size
+    std::uint32_t compression;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(ArchiveHeader) == 16 && sizeof(ArchiveEntry) == 48);
+
+// sf::InputStream over an archive entry. For raw entries it reads straight
+// from the mapping; LZ4 entries are inflated once into a private buffer.
+class ArchiveInputStream : public sf::InputStream
+{
+private:
+    const std::uint8_t *data;
+    std::size_t size;
+    std::size_t position;
+    std::vector<std::uint8_t> inflated;
+
+public:
+    ArchiveInputStream(const std::uint8_t *bytes, std::size_t length);
+    explicit ArchiveInputStream(std::vector<std::uint8_t> decompressed);
+
+    std::optional<std::size_t> read(void *out, std::size_t count) override;
+    std::optional<std::size_t> seek(std::size_t newPosition) override;
+    std::optional<std::size_t> tell() override;
+    std::optional<std::size_t> getSize() override;
+
+    // Whole entry at once, for loadFromMemory-style APIs
+    const std::uint8_t *getData() const { return data; }
+};
+
+class AssetArchive
+{
+private:
+    MappedFile mapping;
+    const ArchiveEntry *entries;
+    std::uint32_t entryCount;
+    const char *names;
+    std::size_t namesSize;
+
+    const ArchiveEntry *find(const std::string &name) const;
+
+public:
+    AssetArchive();
+
+    bool open(const std::string &path);
+    bool isOpen() const { return mapping.isOpen(); }
+    bool contains(const std::string &name) const { return find(name) != nullptr; }
+
+    // Null when the entry is missing or corrupt. The stream must not
+    // outlive the archive.
+    std::unique_ptr<ArchiveInputStream> openStream(const std::string &name) const;
+};
+
+// Builds archives; used by the assetpack tool
+class AssetArchiveWriter
+{
+private:
+    struct Pending
+    {
+        std::string name;
+        std::vector<std::uint8_t> bytes; // Stored form
+        std::uint64_t size;
+        ArchiveFormat::Compression compression;
+    };
+    std::vector<Pending> pending;
+
+public:
+    // Compresses only when LZ4 saves at least 10%; already-compressed formats
+    // (PNG, OGG, ...) are stored raw so they stay zero-copy
+    void add(const std::string &name, std::vector<std::uint8_t> bytes, bool allowCompression);
+    bool writeFile(const std::string &path) const;
+};
+
+std::uint64_t archiveNameHash(const std::string &name);
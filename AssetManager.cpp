@@ -0,0 +1,302 @@
+#include "AssetManager.h"
+#include <SFML/System/FileInputStream.hpp>
+#include <algorithm>
+#include <iomanip>
+
+std::unique_ptr<sf::InputStream> openAssetSource(const AssetArchive *archive, const std::string &root,
+                                                 const std::string &name)
+{
+    if (archive && archive->contains(name))
+        return archive->openStream(name);
+
+    auto file = std::make_unique<sf::FileInputStream>();
+    if (!file->open(root + "/" + name))
+        return nullptr;
+    return file;
+}
+
+// ============= AssetManager Implementation =============
+
+AssetManager::AssetManager(const AssetArchive *assets, const std::string &looseRoot, unsigned int workerCount)
+    : archive(assets), root(looseRoot), outstanding(0), stopping(false)
+{
+    // Magenta checker: obvious on screen if an asset never arrives
+    sf::Image checker({2, 2}, sf::Color::Magenta);
+    checker.setPixel({0, 1}, sf::Color::Black);
+    checker.setPixel({1, 0}, sf::Color::Black);
+    (void)placeholderTexture.loadFromImage(checker);
+
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::min(4u, std::thread::hardware_concurrency() - 1));
+    for (unsigned int i = 0; i < workerCount; ++i)
+        workers.emplace_back([this]
+                             { workerLoop(); });
+}
+
+AssetManager::~AssetManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void AssetManager::enqueue(std::function<void()> job)
+{
+    outstanding.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobReady.notify_one();
+}
+
+void AssetManager::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]
+                          { return stopping || !jobs.empty(); });
+            if (stopping)
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+std::unique_ptr<sf::InputStream> AssetManager::openSource(const std::string &name) const
+{
+    return openAssetSource(archive, root, name);
+}
+
+void AssetManager::postRenderTask(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(taskMutex);
+    renderTasks.push_back(std::move(task));
+}
+
+void AssetManager::addReport(const std::string &name, const char *type, float queued, float decoded, float ready, bool ok)
+{
+    std::lock_guard<std::mutex> lock(reportMutex);
+    report.push_back({name, type, (decoded - queued) * 1000.0f, (ready - decoded) * 1000.0f,
+                      (ready - queued) * 1000.0f, ok});
+}
+
+TextureHandle AssetManager::loadTexture(const std::string &name)
+{
+    if (auto existing = textures[name].lock())
+        return TextureHandle(existing, &placeholderTexture);
+
+    auto slot = std::make_shared<AssetSlot<sf::Texture>>();
+    slot->name = name;
+    slot->queuedAt = now();
+    textures[name] = slot;
+
+    enqueue([this, slot]
+            {
+                std::unique_ptr<sf::InputStream> source = openSource(slot->name);
+                bool ok = source && slot->image.loadFromStream(*source);
+                slot->decodedAt = now();
+
+                if (!ok)
+                {
+                    slot->state.store(AssetState::Failed, std::memory_order_release);
+                    addReport(slot->name, "texture", slot->queuedAt, slot->decodedAt, slot->decodedAt, false);
+                    outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                    return;
+                }
+
+                // Still counted as outstanding until pump() uploads it
+                slot->state.store(AssetState::Decoded, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(uploadMutex);
+                uploads.push_back(slot); });
+
+    return TextureHandle(slot, &placeholderTexture);
+}
+
+FontHandle AssetManager::loadFont(const std::string &name)
+{
+    if (auto existing = fonts[name].lock())
+        return FontHandle(existing, &placeholderFont);
+
+    auto slot = std::make_shared<AssetSlot<sf::Font>>();
+    slot->name = name;
+    slot->queuedAt = now();
+    fonts[name] = slot;
+
+    enqueue([this, slot]
+            {
+                // Opening parses the face; glyphs are rasterized later, on use
+                slot->stream = openSource(slot->name);
+                bool ok = slot->stream && slot->resource.openFromStream(*slot->stream);
+                slot->decodedAt = slot->readyAt = now();
+                slot->state.store(ok ? AssetState::Ready : AssetState::Failed, std::memory_order_release);
+                addReport(slot->name, "font", slot->queuedAt, slot->decodedAt, slot->readyAt, ok);
+                outstanding.fetch_sub(1, std::memory_order_acq_rel); });
+
+    return FontHandle(slot, &placeholderFont);
+}
+
+SoundHandle AssetManager::loadSound(const std::string &name)
+{
+    if (auto existing = sounds[name].lock())
+        return SoundHandle(existing, &placeholderSound);
+
+    auto slot = std::make_shared<AssetSlot<sf::SoundBuffer>>();
+    slot->name = name;
+    slot->queuedAt = now();
+    sounds[name] = slot;
+
+    enqueue([this, slot]
+            {
+                // Fully decodes to PCM samples here, off the main thread
+                std::unique_ptr<sf::InputStream> source = openSource(slot->name);
+                bool ok = source && slot->resource.loadFromStream(*source);
+                slot->decodedAt = slot->readyAt = now();
+                slot->state.store(ok ? AssetState::Ready : AssetState::Failed, std::memory_order_release);
+                addReport(slot->name, "sound", slot->queuedAt, slot->decodedAt, slot->readyAt, ok);
+                outstanding.fetch_sub(1, std::memory_order_acq_rel); });
+
+    return SoundHandle(slot, &placeholderSound);
+}
+
+// A slot still on its first load is skipped; that load will read the new file
+template <typename T>
+static std::shared_ptr<AssetSlot<T>> settledSlot(std::unordered_map<std::string, std::weak_ptr<AssetSlot<T>>> &slots, const std::string &name)
+{
+    auto it = slots.find(name);
+    if (it == slots.end())
+        return nullptr;
+    auto slot = it->second.lock();
+    if (!slot)
+        return nullptr;
+    AssetState state = slot->state.load(std::memory_order_acquire);
+    return (state == AssetState::Ready || state == AssetState::Failed) ? slot : nullptr;
+}
+
+void AssetManager::reload(const std::string &name)
+{
+    if (auto slot = settledSlot(textures, name))
+    {
+        enqueue([this, slot]
+                {
+                    auto image = std::make_shared<sf::Image>();
+                    std::unique_ptr<sf::InputStream> source = openSource(slot->name);
+                    if (!source || !image->loadFromStream(*source))
+                    {
+                        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                        return; // Keep the old texture (the file may be mid-save)
+                    }
+                    postRenderTask([slot, image]
+                                   {
+                                       if (slot->resource.loadFromImage(*image))
+                                           slot->state.store(AssetState::Ready, std::memory_order_release);
+                                   }); });
+    }
+
+    if (auto slot = settledSlot(fonts, name))
+    {
+        enqueue([this, slot]
+                {
+                    // The stream lives on the heap, so moving the pointer keeps
+                    // FreeType's reference to it valid
+                    auto fresh = std::make_shared<AssetSlot<sf::Font>>();
+                    fresh->stream = openSource(slot->name);
+                    if (!fresh->stream || !fresh->resource.openFromStream(*fresh->stream))
+                    {
+                        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                        return;
+                    }
+                    postRenderTask([slot, fresh]
+                                   {
+                                       // Same object address, so sf::Text instances keep working
+                                       slot->resource = std::move(fresh->resource);
+                                       slot->stream = std::move(fresh->stream);
+                                       slot->state.store(AssetState::Ready, std::memory_order_release);
+                                   }); });
+    }
+
+    if (auto slot = settledSlot(sounds, name))
+    {
+        enqueue([this, slot]
+                {
+                    std::unique_ptr<sf::InputStream> source = openSource(slot->name);
+                    auto buffer = std::make_shared<sf::SoundBuffer>();
+                    if (!source || !buffer->loadFromStream(*source))
+                    {
+                        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+                        return;
+                    }
+                    postRenderTask([slot, buffer]
+                                   {
+                                       // Copy assignment re-binds any playing sf::Sound
+                                       slot->resource = *buffer;
+                                       slot->state.store(AssetState::Ready, std::memory_order_release);
+                                   }); });
+    }
+}
+
+void AssetManager::pump(float budgetMs)
+{
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.swap(renderTasks);
+    }
+    for (auto &task : tasks)
+    {
+        task();
+        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    std::vector<std::shared_ptr<AssetSlot<sf::Texture>>> batch;
+    {
+        std::lock_guard<std::mutex> lock(uploadMutex);
+        batch.swap(uploads);
+    }
+
+    float start = now();
+    std::size_t i = 0;
+    for (; i < batch.size(); ++i)
+    {
+        if (i > 0 && (now() - start) * 1000.0f > budgetMs)
+            break;
+
+        auto &slot = batch[i];
+        bool ok = slot->resource.loadFromImage(slot->image);
+        slot->image = sf::Image(); // Pixels now live on the GPU
+        slot->readyAt = now();
+        slot->state.store(ok ? AssetState::Ready : AssetState::Failed, std::memory_order_release);
+        addReport(slot->name, "texture", slot->queuedAt, slot->decodedAt, slot->readyAt, ok);
+        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // Over budget: the rest waits for the next frame, ahead of newer uploads
+    if (i < batch.size())
+    {
+        std::lock_guard<std::mutex> lock(uploadMutex);
+        uploads.insert(uploads.begin(), batch.begin() + static_cast<std::ptrdiff_t>(i), batch.end());
+    }
+}
+
+void AssetManager::printReport(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(reportMutex);
+    out << "Asset load report (" << report.size() << " assets)\n"
+        << "  type     decode ms  upload ms   total ms  name\n";
+    for (const ReportEntry &e : report)
+    {
+        out << "  " << std::left << std::setw(7) << e.type << std::right << std::fixed << std::setprecision(2)
+            << std::setw(11) << e.decodeMs << std::setw(11) << e.uploadMs << std::setw(11) << e.totalMs
+            << "  " << e.name << (e.ok ? "" : "  (FAILED)") << "\n";
+    }
+    out.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Clock.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "AssetArchive.h"
+
+enum class AssetState
+{
+    Pending, // Queued or decoding on a worker
+    Decoded, // Textures only: pixels ready, waiting for the GL upload
+    Ready,
+    Failed
+};
+
+// Shared state behind a handle. Workers fill 'resource' (or 'image') and then
+// publish the new state; the render thread only reads after seeing Ready.
+template <typename T>
+struct AssetSlot
+{
+    std::string name;
+    std::atomic<AssetState> state{AssetState::Pending};
+    T resource;
+    sf::Image image;                       // Textures: decoded pixels awaiting upload
+    std::unique_ptr<sf::InputStream> stream; // Fonts: FreeType keeps reading from it
+    float queuedAt = 0, decodedAt = 0, readyAt = 0;
+};
+
+// Reference-counted view of an asset. Until the asset is ready, get()
+// returns the manager's placeholder, so callers can draw from frame one.
+template <typename T>
+class AssetHandle
+{
+private:
+    std::shared_ptr<AssetSlot<T>> slot;
+    const T *placeholder;
+
+public:
+    AssetHandle() : placeholder(nullptr) {}
+    AssetHandle(std::shared_ptr<AssetSlot<T>> s, const T *fallback) : slot(std::move(s)), placeholder(fallback) {}
+
+    bool isValid() const { return slot != nullptr; }
+    bool isReady() const { return slot && slot->state.load(std::memory_order_acquire) == AssetState::Ready; }
+    bool hasFailed() const { return slot && slot->state.load(std::memory_order_acquire) == AssetState::Failed; }
+    const T &get() const { return isReady() ? slot->resource : *placeholder; }
+};
+
+using TextureHandle = AssetHandle<sf::Texture>;
+using FontHandle = AssetHandle<sf::Font>;
+using SoundHandle = AssetHandle<sf::SoundBuffer>;
+
+// Raw stream for 'name' from 'archive' (may be null) or else from the loose
+// 'root'; null when it is in neither. Usable before an AssetManager exists.
+std::unique_ptr<sf::InputStream> openAssetSource(const AssetArchive *archive, const std::string &root,
+                                                 const std::string &name);
+
+// Loads assets from an AssetArchive (when one is open) or from loose files
+// under a root directory. Decoding runs on worker threads; only the GL
+// texture upload happens on the render thread, inside pump().
+class AssetManager
+{
+private:
+    struct ReportEntry
+    {
+        std::string name;
+        const char *type;
+        float decodeMs;
+        float uploadMs;
+        float totalMs;
+        bool ok;
+    };
+
+    const AssetArchive *archive;
+    std::string root;
+    sf::Clock clock;
+
+    sf::Texture placeholderTexture;
+    sf::Font placeholderFont;
+    sf::SoundBuffer placeholderSound;
+
+    // Requests are deduplicated by name while any handle is alive
+    std::unordered_map<std::string, std::weak_ptr<AssetSlot<sf::Texture>>> textures;
+    std::unordered_map<std::string, std::weak_ptr<AssetSlot<sf::Font>>> fonts;
+    std::unordered_map<std::string, std::weak_ptr<AssetSlot<sf::SoundBuffer>>> sounds;
+
+    std::mutex uploadMutex;
+    std::vector<std::shared_ptr<AssetSlot<sf::Texture>>> uploads;
+
+    // Work that must run on the render thread, queued by workers (hot reloads)
+    std::mutex taskMutex;
+    std::vector<std::function<void()>> renderTasks;
+
+    std::mutex reportMutex;
+    std::vector<ReportEntry> report;
+
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> workers;
+    std::atomic<int> outstanding;
+    bool stopping;
+
+    float now() const { return clock.getElapsedTime().asSeconds(); }
+    void enqueue(std::function<void()> job);
+    void workerLoop();
+    std::unique_ptr<sf::InputStream> openSource(const std::string &name) const;
+    void postRenderTask(std::function<void()> task);
+    void addReport(const std::string &name, const char *type, float queued, float decoded, float ready, bool ok);
+
+public:
+    // 'assets' may be null; it must outlive the manager. Must be constructed
+    // on the render thread (the placeholder texture is a GL object).
+    AssetManager(const AssetArchive *assets, const std::string &looseRoot, unsigned int workerCount = 0);
+    ~AssetManager();
+    AssetManager(const AssetManager &) = delete;
+    AssetManager &operator=(const AssetManager &) = delete;
+
+    TextureHandle loadTexture(const std::string &name);
+    FontHandle loadFont(const std::string &name);
+    SoundHandle loadSound(const std::string &name);
+
+    // Re-decodes an asset that changed on disk. Live handles keep showing the
+    // old version until the new one is swapped in by pump(). No-op when
+    // nothing holds the asset.
+    void reload(const std::string &name);
+
+    // Render thread, once per frame: uploads decoded textures until the
+    // time budget is spent so a burst of loads cannot stall a frame, and
+    // applies finished reloads
+    void pump(float budgetMs = 2.0f);
+
+    bool isIdle() const { return outstanding.load(std::memory_order_acquire) == 0; }
+    void printReport(std::ostream &out);
+};
@@ -0,0 +1,25 @@
+#include "Camera.h"
+#include <algorithm>
+
+// ============= Camera Implementation =============
+
+Camera::Camera(sf::Vector2<float> size) : view(size * 0.5f, size) {}
+
+void Camera::follow(sf::Vector2<float> target)
+{
+    sf::Vector2<float> center = target;
+    if (bounds.size.x > 0 && bounds.size.y > 0)
+    {
+        sf::Vector2<float> half = view.getSize() * 0.5f;
+        sf::Vector2<float> min = bounds.position + half, max = bounds.position + bounds.size - half;
+        center.x = min.x <= max.x ? std::clamp(center.x, min.x, max.x) : bounds.getCenter().x;
+        center.y = min.y <= max.y ? std::clamp(center.y, min.y, max.y) : bounds.getCenter().y;
+    }
+    view.setCenter(center);
+}
+
+sf::Rect<float> Camera::getVisibleArea() const
+{
+    // The view is never rotated, so its rectangle is axis-aligned
+    return {view.getCenter() - view.getSize() * 0.5f, view.getSize()};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/View.hpp>
+
+// Scrolling view that keeps a target centred. When the level is larger than
+// the view, the view is clamped so it never shows past the level's edges;
+// along an axis where the level is smaller it stays centred on the level.
+class Camera
+{
+private:
+    sf::View view;
+    sf::Rect<float> bounds; // Empty = unbounded
+
+public:
+    explicit Camera(sf::Vector2<float> size);
+
+    void setBounds(const sf::Rect<float> &area) { bounds = area; }
+    void setSize(sf::Vector2<float> size) { view.setSize(size); }
+    void follow(sf::Vector2<float> target);
+
+    const sf::View &getView() const { return view; }
+    // World-space rectangle on screen, for culling
+    sf::Rect<float> getVisibleArea() const;
+};
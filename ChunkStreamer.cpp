@@ -0,0 +1,195 @@
+#include "ChunkStreamer.h"
+#include <algorithm>
+#include <cstdlib>
+
+// ============= LevelChunkData Implementation =============
+
+StaticBvh LevelChunkData::getWallBvh() const
+{
+    return StaticBvh(bvhNodes.data(), static_cast<std::uint32_t>(bvhNodes.size()),
+                     bvhItems.data(), static_cast<std::uint32_t>(bvhItems.size()));
+}
+
+std::size_t LevelChunkData::getMemoryBytes() const
+{
+    return sizeof(*this) + walls.capacity() * sizeof(LevelRect) +
+           destructibles.capacity() * sizeof(LevelDestructible) + spawns.capacity() * sizeof(LevelSpawn) +
+           bvhNodes.capacity() * sizeof(BvhNode) + bvhItems.capacity() * sizeof(std::uint32_t);
+}
+
+// ============= ChunkStreamer Implementation =============
+
+ChunkStreamer::ChunkStreamer(std::shared_ptr<const Level> chunkedLevel, std::size_t memoryCapBytes)
+    : level(std::move(chunkedLevel)), memoryCap(memoryCapBytes), memoryUsed(0), stopping(false),
+      hits(0), prefetched(0), stalls(0), evictions(0)
+{
+    worker = std::thread(&ChunkStreamer::workerLoop, this);
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requested.notify_all();
+    worker.join();
+}
+
+std::uint64_t ChunkStreamer::keyOf(std::int32_t x, std::int32_t y)
+{
+    return (std::uint64_t(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+std::shared_ptr<const LevelChunkData> ChunkStreamer::load(const LevelChunk &chunk) const
+{
+    // Copying out of the mapping is what pages the chunk in from disk
+    auto data = std::make_shared<LevelChunkData>();
+    data->x = chunk.x;
+    data->y = chunk.y;
+    data->destructibleFirst = chunk.destructibleFirst;
+    data->walls.assign(level->getWalls() + chunk.wallFirst, level->getWalls() + chunk.wallFirst + chunk.wallCount);
+    data->destructibles.assign(level->getDestructibles() + chunk.destructibleFirst,
+                               level->getDestructibles() + chunk.destructibleFirst + chunk.destructibleCount);
+    data->spawns.assign(level->getSpawns() + chunk.spawnFirst, level->getSpawns() + chunk.spawnFirst + chunk.spawnCount);
+    StaticBvh::build(data->walls, data->bvhNodes, data->bvhItems);
+    return data;
+}
+
+void ChunkStreamer::insert(std::uint64_t key, std::shared_ptr<const LevelChunkData> data)
+{
+    Entry &entry = cache[key];
+    memoryUsed += data->getMemoryBytes();
+    entry.data = std::move(data);
+    lru.push_front(key);
+    entry.lruPosition = lru.begin();
+    loaded.notify_all();
+    evict(key);
+}
+
+void ChunkStreamer::evict(std::uint64_t keep)
+{
+    // Oldest first; chunks a World still holds (use_count > 1) are skipped,
+    // and so is 'keep', the chunk just inserted: while held chunks exceed
+    // the cap it would otherwise be evicted before anyone could take it
+    auto it = lru.end();
+    while (memoryUsed > memoryCap && it != lru.begin())
+    {
+        --it;
+        if (*it == keep)
+            continue;
+        auto found = cache.find(*it);
+        if (found->second.data.use_count() > 1)
+            continue;
+
+        memoryUsed -= found->second.data->getMemoryBytes();
+        cache.erase(found);
+        it = lru.erase(it);
+        ++evictions;
+    }
+}
+
+void ChunkStreamer::prefetch(std::int32_t x, std::int32_t y, std::int32_t radius)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.clear(); // Requests for where the player used to be are stale
+
+        for (std::int32_t ring = 0; ring <= radius; ++ring)
+        {
+            for (std::int32_t dy = -ring; dy <= ring; ++dy)
+            {
+                for (std::int32_t dx = -ring; dx <= ring; ++dx)
+                {
+                    if (std::max(std::abs(dx), std::abs(dy)) != ring)
+                        continue;
+                    std::uint64_t key = keyOf(x + dx, y + dy);
+                    if (!cache.count(key) && level->findChunk(x + dx, y + dy))
+                        queue.push_back(key);
+                }
+            }
+        }
+    }
+    requested.notify_one();
+}
+
+std::shared_ptr<const LevelChunkData> ChunkStreamer::acquire(std::int32_t x, std::int32_t y)
+{
+    const LevelChunk *chunk = level->findChunk(x, y);
+    if (!chunk)
+        return nullptr;
+
+    std::uint64_t key = keyOf(x, y);
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    bool waited = it != cache.end() && !it->second.data;
+    if (waited)
+    {
+        // The worker is loading it right now. Another insert may evict it
+        // before this thread wakes, in which case it is loaded here below.
+        loaded.wait(lock, [&]
+                    {
+                        it = cache.find(key);
+                        return it == cache.end() || it->second.data != nullptr; });
+    }
+    if (it != cache.end())
+    {
+        ++(waited ? stalls : hits);
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        return it->second.data;
+    }
+
+    // Not requested in time (or evicted while waiting): claim it, then load here
+    ++stalls;
+    cache[key];
+    lock.unlock();
+    std::shared_ptr<const LevelChunkData> data = load(*chunk);
+    lock.lock();
+    insert(key, data);
+    return data;
+}
+
+void ChunkStreamer::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        requested.wait(lock, [this]
+                       { return stopping || !queue.empty(); });
+        if (stopping)
+            return;
+
+        std::uint64_t key = queue.front();
+        queue.pop_front();
+        if (cache.count(key))
+            continue;
+
+        auto x = static_cast<std::int32_t>(key >> 32);
+        auto y = static_cast<std::int32_t>(key & 0xFFFFFFFFu);
+        const LevelChunk *chunk = level->findChunk(x, y);
+        if (!chunk)
+            continue;
+
+        cache[key]; // Placeholder, so acquire() waits instead of loading twice
+        lock.unlock();
+        std::shared_ptr<const LevelChunkData> data = load(*chunk);
+        lock.lock();
+        insert(key, std::move(data));
+        ++prefetched;
+    }
+}
+
+void ChunkStreamer::printStats(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "Chunks: " << lru.size() << " cached, " << memoryUsed / 1024 << " / " << memoryCap / 1024
+        << " KB, " << hits << " hits, " << prefetched << " prefetched, " << stalls << " stalls, "
+        << evictions << " evicted\n";
+}
+
+std::unique_ptr<ChunkStreamer> createChunkStreamer(const std::shared_ptr<const Level> &level, int cacheMb)
+{
+    if (!level || !level->isChunked())
+        return nullptr;
+    return std::make_unique<ChunkStreamer>(level, static_cast<std::size_t>(std::max(cacheMb, 1)) * 1024 * 1024);
+}
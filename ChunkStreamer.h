@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Level.h"
+
+// One chunk copied out of the level file, with its own wall BVH, ready to be
+// instantiated by a World. Immutable once loaded, so worlds on any thread
+// can share it.
+struct LevelChunkData
+{
+    std::int32_t x, y;
+    std::uint32_t destructibleFirst; // Level index of destructibles[0]
+    std::vector<LevelRect> walls;
+    std::vector<LevelDestructible> destructibles;
+    std::vector<LevelSpawn> spawns;
+    std::vector<BvhNode> bvhNodes;
+    std::vector<std::uint32_t> bvhItems;
+
+    StaticBvh getWallBvh() const;
+    std::size_t getMemoryBytes() const;
+};
+
+// Loads chunks of a chunked level on a background thread and keeps them in
+// an LRU cache capped at 'memoryCap' bytes. Chunks still held by a World are
+// never evicted, so the cap can be exceeded while the active area is larger
+// than it. Thread-safe.
+class ChunkStreamer
+{
+private:
+    struct Entry
+    {
+        std::shared_ptr<const LevelChunkData> data; // Null while loading
+        std::list<std::uint64_t>::iterator lruPosition;
+    };
+
+    std::shared_ptr<const Level> level;
+    std::size_t memoryCap;
+
+    std::mutex mutex;
+    std::condition_variable loaded;
+    std::condition_variable requested;
+    std::unordered_map<std::uint64_t, Entry> cache;
+    std::list<std::uint64_t> lru; // Front is most recently used
+    std::size_t memoryUsed;
+    std::deque<std::uint64_t> queue;
+    bool stopping;
+    std::thread worker;
+
+    // Counters for printStats()
+    std::uint64_t hits, prefetched, stalls, evictions;
+
+    static std::uint64_t keyOf(std::int32_t x, std::int32_t y);
+    std::shared_ptr<const LevelChunkData> load(const LevelChunk &chunk) const;
+    void insert(std::uint64_t key, std::shared_ptr<const LevelChunkData> data);
+    void evict(std::uint64_t keep);
+    void workerLoop();
+
+public:
+    ChunkStreamer(std::shared_ptr<const Level> chunkedLevel, std::size_t memoryCapBytes);
+    ~ChunkStreamer();
+    ChunkStreamer(const ChunkStreamer &) = delete;
+    ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+
+    // Queues background loads for every chunk within 'radius' chunks of
+    // (x, y), nearest first. Cheap for chunks already cached or queued.
+    void prefetch(std::int32_t x, std::int32_t y, std::int32_t radius);
+
+    // Returns the chunk, loading it on the calling thread if the background
+    // load has not finished (counted as a stall). Null for empty chunks.
+    std::shared_ptr<const LevelChunkData> acquire(std::int32_t x, std::int32_t y);
+
+    const Level &getLevel() const { return *level; }
+    void printStats(std::ostream &out);
+};
+
+// A streamer for 'level' if it is chunked, otherwise null (load it whole)
+std::unique_ptr<ChunkStreamer> createChunkStreamer(const std::shared_ptr<const Level> &level, int cacheMb);
@@ -0,0 +1,177 @@
+#include "DestructibleBuffer.h"
+#include <SFML/Graphics/RenderStates.hpp>
+#include <algorithm>
+
+// ============= DestructibleBuffer Implementation =============
+
+DestructibleBuffer::DestructibleBuffer(const TextureAtlas &textures)
+    : atlas(textures), buffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic), generation(0),
+      stale(true), failed(false), lastUploadBytes(0) {}
+
+void DestructibleBuffer::write(std::uint32_t slot, const DestructibleObject &object)
+{
+    // Same quad and tint rule as SpriteBatch, so both paths look alike
+    const AtlasRegion &region = atlas.get(object.getSprite());
+    sf::Color tint = region.tinted ? object.getColor() : sf::Color::White;
+    sf::Rect<float> rect = object.getBounds();
+    sf::Vector2<float> p0 = rect.position, p1 = rect.position + rect.size;
+    sf::Vector2<float> t0 = region.texRect.position, t1 = region.texRect.position + region.texRect.size;
+
+    sf::Vertex *quad = &vertices[slot * VerticesPerObject];
+    quad[0] = {p0, tint, t0};
+    quad[1] = {{p1.x, p0.y}, tint, {t1.x, t0.y}};
+    quad[2] = {{p0.x, p1.y}, tint, {t0.x, t1.y}};
+    quad[3] = {{p0.x, p1.y}, tint, {t0.x, t1.y}};
+    quad[4] = {{p1.x, p0.y}, tint, {t1.x, t0.y}};
+    quad[5] = {p1, tint, t1};
+    dirtySlots.push_back(slot);
+}
+
+void DestructibleBuffer::release(std::uint32_t id)
+{
+    auto found = slots.find(id);
+    if (found == slots.end())
+        return;
+
+    // Zero-area triangles rasterize nothing, so the slot can stay in the
+    // drawn range until it is reused
+    std::uint32_t slot = found->second;
+    std::fill_n(vertices.begin() + static_cast<std::ptrdiff_t>(slot * VerticesPerObject), VerticesPerObject,
+                sf::Vertex());
+    dirtySlots.push_back(slot);
+    freeSlots.push_back(slot);
+    slots.erase(found);
+}
+
+void DestructibleBuffer::apply(const World &world)
+{
+    if (stale || world.getStaticGeneration() != generation)
+    {
+        stale = true; // Everything is rewritten on the next draw anyway
+        return;
+    }
+    const std::vector<std::uint32_t> &changes = world.getDestructibleChanges();
+    if (changes.empty())
+        return;
+
+    changed.assign(changes.begin(), changes.end());
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    seen.assign(changed.size(), 0);
+
+    for (const DestructibleObject &dest : world.getDestructibles())
+    {
+        auto it = std::lower_bound(changed.begin(), changed.end(), dest.getId());
+        if (it == changed.end() || *it != dest.getId() || !dest.getActive())
+            continue;
+        seen[static_cast<std::size_t>(it - changed.begin())] = 1;
+
+        auto [entry, added] = slots.try_emplace(dest.getId(), 0);
+        if (added)
+        {
+            if (!freeSlots.empty())
+            {
+                entry->second = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            else
+            {
+                entry->second = static_cast<std::uint32_t>(vertices.size() / VerticesPerObject);
+                vertices.resize(vertices.size() + VerticesPerObject);
+            }
+        }
+        write(entry->second, dest);
+    }
+
+    // Destroyed (and already removed from the world) or unloaded
+    for (std::size_t i = 0; i < changed.size(); ++i)
+        if (!seen[i])
+            release(changed[i]);
+}
+
+bool DestructibleBuffer::rebuild(const World &world)
+{
+    slots.clear();
+    freeSlots.clear();
+    vertices.clear();
+    for (const DestructibleObject &dest : world.getDestructibles())
+    {
+        if (!dest.getActive())
+            continue;
+        auto slot = static_cast<std::uint32_t>(vertices.size() / VerticesPerObject);
+        slots[dest.getId()] = slot;
+        vertices.resize(vertices.size() + VerticesPerObject);
+        write(slot, dest);
+    }
+    generation = world.getStaticGeneration();
+    stale = false;
+    return refill();
+}
+
+bool DestructibleBuffer::refill()
+{
+    dirtySlots.clear();
+    if (vertices.empty())
+        return true;
+    if (vertices.size() > buffer.getVertexCount() &&
+        !buffer.create(std::max(vertices.size(), buffer.getVertexCount() * 2)))
+        return false;
+    lastUploadBytes += vertices.size() * sizeof(sf::Vertex);
+    return buffer.update(vertices.data(), vertices.size(), 0);
+}
+
+bool DestructibleBuffer::upload()
+{
+    if (dirtySlots.empty())
+        return true;
+    if (vertices.size() > buffer.getVertexCount())
+        return refill(); // New slots past the end: the buffer has to grow
+
+    // One update per run of adjacent slots; hits are usually a handful of
+    // scattered objects, so each run is one object
+    std::sort(dirtySlots.begin(), dirtySlots.end());
+    dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+    for (std::size_t i = 0; i < dirtySlots.size();)
+    {
+        std::size_t end = i + 1;
+        while (end < dirtySlots.size() && dirtySlots[end] == dirtySlots[end - 1] + 1)
+            ++end;
+
+        std::size_t first = dirtySlots[i] * VerticesPerObject, count = (end - i) * VerticesPerObject;
+        if (!buffer.update(&vertices[first], count, static_cast<unsigned int>(first)))
+            return false;
+        lastUploadBytes += count * sizeof(sf::Vertex);
+        i = end;
+    }
+    dirtySlots.clear();
+    return true;
+}
+
+bool DestructibleBuffer::draw(sf::RenderTarget &target, const World &world)
+{
+    lastUploadBytes = 0;
+    if (failed)
+        return false;
+    if (!sf::VertexBuffer::isAvailable())
+    {
+        failed = true;
+        return false;
+    }
+
+    bool uploaded = (stale || world.getStaticGeneration() != generation) ? rebuild(world) : upload();
+    if (!uploaded)
+    {
+        failed = true;
+        return false;
+    }
+    const AtlasRegion &region = atlas.get(SpriteId::Destructible);
+    if (region.page >= atlas.getPageCount())
+        return false; // Atlas not uploaded
+    if (vertices.empty())
+        return true;
+
+    sf::RenderStates states;
+    states.texture = &atlas.getPage(region.page);
+    target.draw(buffer, 0, vertices.size(), states);
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "TextureAtlas.h"
+#include "World.h"
+
+// Every destructible as two triangles in one persistent vertex buffer, drawn
+// with a single call. The buffer is only filled in full when the static layer
+// is replaced (level swap, snapshot restore); after that a destructible that
+// is damaged, destroyed, streamed in or unloaded rewrites just its own six
+// vertices, so frames in which nothing is hit upload nothing. Destructibles
+// off screen are drawn too: there are few enough that culling them would
+// cost more than the vertices.
+class DestructibleBuffer
+{
+private:
+    static constexpr std::size_t VerticesPerObject = 6;
+
+    const TextureAtlas &atlas;
+    sf::VertexBuffer buffer;          // Triangles; grown by doubling
+    std::vector<sf::Vertex> vertices; // What the buffer holds, to refill it after growing
+    std::unordered_map<std::uint32_t, std::uint32_t> slots; // Object id -> slot
+    std::vector<std::uint32_t> freeSlots; // Degenerate, reused before the end grows
+    std::vector<std::uint32_t> dirtySlots; // Written since the last upload
+    std::vector<std::uint32_t> changed;    // Scratch for apply()
+    std::vector<std::uint8_t> seen;        // Scratch for apply(), one per 'changed'
+    std::uint32_t generation;
+    bool stale;  // Refill everything on the next draw
+    bool failed; // No vertex buffers on this GL; callers draw through the queue
+    std::size_t lastUploadBytes;
+
+    void write(std::uint32_t slot, const DestructibleObject &object);
+    void release(std::uint32_t id);
+    bool rebuild(const World &world);
+    bool refill();
+    bool upload();
+
+public:
+    explicit DestructibleBuffer(const TextureAtlas &textures);
+
+    // After each World::update(): patches the objects it reports as changed
+    void apply(const World &world);
+
+    // Uploads what changed since the last call and draws every destructible
+    // into 'target', whose view must already be set. Returns false without
+    // drawing if vertex buffers are missing, in which case the caller draws
+    // World::renderDestructibles() itself.
+    bool draw(sf::RenderTarget &target, const World &world);
+
+    std::size_t getLastUploadBytes() const { return lastUploadBytes; }
+};
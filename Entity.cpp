@@ -5,10 +5,36 @@
 // ============= GameObject Implementation =============
 
 GameObject::GameObject(float x, float y, float w, float h)
-    : position(x, y), size(w, h), isActive(true) {}
+    : position(x, y), size(w, h), isActive(true), id(0) {}
 
 GameObject::~GameObject() {}
 
+void GameObject::hashState(StateHash &hash) const
+{
+    hash.add(id);
+    hash.add(position);
+    hash.add(size);
+    hash.add(isActive);
+}
+
+void GameObject::saveState(ObjectRecord &record) const
+{
+    record.id = id;
+    record.active = isActive;
+    record.x = position.x;
+    record.y = position.y;
+    record.w = size.x;
+    record.h = size.y;
+}
+
+void GameObject::loadState(const ObjectRecord &record)
+{
+    id = record.id;
+    isActive = record.active != 0;
+    position = sf::Vector2<float>(record.x, record.y);
+    size = sf::Vector2<float>(record.w, record.h);
+}
+
 // ============= Entity Implementation =============
 
 Entity::Entity(float x, float y, float w, float h, float spd, sf::Color col)
@@ -26,12 +52,33 @@ void Entity::update(float dt)
     position.y += velocity.y * dt;
 }
 
-void Entity::render(sf::RenderWindow &window)
+void Entity::hashState(StateHash &hash) const
+{
+    GameObject::hashState(hash);
+    hash.add(velocity);
+    hash.add(speed);
+}
+
+void Entity::saveState(EntityRecord &record) const
+{
+    GameObject::saveState(record.object);
+    record.vx = velocity.x;
+    record.vy = velocity.y;
+    record.speed = speed;
+    record.color = color.toInteger();
+}
+
+void Entity::loadState(const EntityRecord &record)
+{
+    GameObject::loadState(record.object);
+    velocity = sf::Vector2<float>(record.vx, record.vy);
+    speed = record.speed;
+    color = sf::Color(record.color);
+}
+
+void Entity::render(RenderQueue &queue) const
 {
-    sf::RectangleShape shape(size);
-    shape.setPosition(position);
-    shape.setFillColor(color);
-    window.draw(shape);
+    queue.draw(getSprite(), getBounds(), color, RenderLayer::Actors);
 }
 
 // ============= Player Implementation =============
@@ -40,18 +87,17 @@ Player::Player(float x, float y)
     : Entity(x, y, 30, 30, 200.0f, sf::Color::Green),
       health(100), canShoot(true), shootCooldown(0.2f), cooldownTimer(0) {}
 
-void Player::handleInput(float dt)
+void Player::handleInput(const PlayerInput &input, float dt)
 {
     float dx = 0, dy = 0;
 
-    // SFML 3.x: Keyboard keys are now in an enum class sf::Keyboard::Key
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W))
+    if (input.up)
         dy = -1;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S))
+    if (input.down)
         dy = 1;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
+    if (input.left)
         dx = -1;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
+    if (input.right)
         dx = 1;
 
     // Normalize diagonal movement
@@ -79,6 +125,32 @@ void Player::update(float dt)
     }
 }
 
+void Player::hashState(StateHash &hash) const
+{
+    Entity::hashState(hash);
+    hash.add(health);
+    hash.add(canShoot);
+    hash.add(cooldownTimer);
+}
+
+void Player::saveState(PlayerRecord &record) const
+{
+    Entity::saveState(record.entity);
+    record.health = health;
+    record.shootCooldown = shootCooldown;
+    record.cooldownTimer = cooldownTimer;
+    record.canShoot = canShoot;
+}
+
+void Player::loadState(const PlayerRecord &record)
+{
+    Entity::loadState(record.entity);
+    health = record.health;
+    shootCooldown = record.shootCooldown;
+    cooldownTimer = record.cooldownTimer;
+    canShoot = record.canShoot != 0;
+}
+
 bool Player::tryShoot()
 {
     if (canShoot)
@@ -118,4 +190,16 @@ void Enemy::update(float dt)
     }
 
     Entity::update(dt);
-}
\ No newline at end of file
+}
+
+void Enemy::saveState(EnemyRecord &record) const
+{
+    Entity::saveState(record.entity);
+    record.detectionRange = detectionRange;
+}
+
+void Enemy::loadState(const EnemyRecord &record)
+{
+    Entity::loadState(record.entity);
+    detectionRange = record.detectionRange;
+}
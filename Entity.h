@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameObject.h"
+#include "PlayerInput.h"
 
 // Forward declaration
 class Player;
@@ -19,7 +20,10 @@ public:
 
     virtual void move(float dx, float dy, float dt);
     virtual void update(float dt) override;
-    virtual void render(sf::RenderWindow &window) override;
+    virtual void render(RenderQueue &queue) const override;
+    virtual void hashState(StateHash &hash) const override;
+    void saveState(EntityRecord &record) const;
+    void loadState(const EntityRecord &record);
 };
 
 // Player class with input handling
@@ -35,8 +39,12 @@ public:
     Player(float x, float y);
     virtual ~Player() override {}
 
-    void handleInput(float dt);
+    void handleInput(const PlayerInput &input, float dt);
     void update(float dt) override;
+    void hashState(StateHash &hash) const override;
+    SpriteId getSprite() const override { return SpriteId::Player; }
+    void saveState(PlayerRecord &record) const;
+    void loadState(const PlayerRecord &record);
     bool tryShoot();
     void takeDamage(float damage);
     float getHealth() const { return health; }
@@ -54,4 +62,7 @@ public:
     virtual ~Enemy() override {}
 
     void update(float dt) override;
+    SpriteId getSprite() const override { return SpriteId::Enemy; }
+    void saveState(EnemyRecord &record) const;
+    void loadState(const EnemyRecord &record);
 };
\ No newline at end of file
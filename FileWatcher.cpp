@@ -0,0 +1,221 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <SFML/System/Time.hpp>
+#endif
+
+namespace
+{
+std::string normalize(const std::string &path)
+{
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+void addUnique(std::vector<std::string> &out, const std::string &path)
+{
+    if (std::find(out.begin(), out.end(), path) == out.end())
+        out.push_back(path);
+}
+} // namespace
+
+// ============= FileWatcher Implementation =============
+
+#if defined(__linux__)
+
+FileWatcher::FileWatcher() : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (fd < 0)
+        std::cerr << "inotify unavailable; hot reload disabled\n";
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+int FileWatcher::addDirectory(const std::string &path, bool wholeTree)
+{
+    if (fd < 0)
+        return -1;
+
+    // Close-after-write and rename-into cover in-place saves and atomic replaces
+    std::uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | (wholeTree ? IN_CREATE : 0);
+    int wd = inotify_add_watch(fd, path.c_str(), mask);
+    if (wd < 0)
+        return -1;
+
+    Directory &dir = directories[wd];
+    dir.path = path;
+    dir.wholeTree = dir.wholeTree || wholeTree;
+    return wd;
+}
+
+bool FileWatcher::watchFile(const std::string &path)
+{
+    std::string file = normalize(path);
+    std::string parent = std::filesystem::path(file).parent_path().generic_string();
+    int wd = addDirectory(parent.empty() ? "." : parent, false);
+    if (wd < 0)
+        return false;
+    directories[wd].files.insert(parent.empty() ? "./" + file : file);
+    return true;
+}
+
+bool FileWatcher::watchTree(const std::string &directory)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+        return false;
+
+    std::string root = normalize(directory);
+    if (addDirectory(root, true) < 0)
+        return false;
+    for (const auto &item : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        if (item.is_directory())
+            addDirectory(item.path().generic_string(), true);
+    }
+    return true;
+}
+
+void FileWatcher::poll(std::vector<std::string> &changed)
+{
+    if (fd < 0)
+        return;
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return; // EAGAIN: nothing more queued
+
+        for (char *p = buffer; p < buffer + length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto it = directories.find(event->wd);
+            if (it == directories.end() || event->len == 0)
+                continue;
+
+            std::string full = it->second.path + "/" + event->name;
+            if (it->second.wholeTree)
+            {
+                if (event->mask & IN_ISDIR)
+                    addDirectory(full, true); // New subdirectory inside a watched tree
+                else
+                    addUnique(changed, full);
+            }
+            else if (it->second.files.count(full))
+            {
+                addUnique(changed, full);
+            }
+        }
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher() {}
+
+FileWatcher::~FileWatcher()
+{
+    if (scan.valid())
+        scan.wait();
+}
+
+void FileWatcher::stamp(const std::string &path)
+{
+    std::error_code error;
+    stamps[path] = std::filesystem::last_write_time(path, error);
+}
+
+void FileWatcher::finishScan()
+{
+    if (!scan.valid())
+        return;
+    for (const std::string &path : scan.get())
+        addUnique(unreported, path);
+}
+
+bool FileWatcher::watchFile(const std::string &path)
+{
+    finishScan();
+    stamp(normalize(path));
+    return true;
+}
+
+bool FileWatcher::watchTree(const std::string &directory)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+        return false;
+
+    finishScan();
+    trees.push_back(normalize(directory));
+    for (const auto &item : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (item.is_regular_file())
+            stamp(item.path().lexically_normal().generic_string());
+    }
+    return true;
+}
+
+std::vector<std::string> FileWatcher::rescan()
+{
+    std::vector<std::string> changed;
+    std::error_code error;
+    for (const std::string &tree : trees)
+    {
+        for (const auto &item : std::filesystem::recursive_directory_iterator(tree, error))
+        {
+            std::string path = item.path().lexically_normal().generic_string();
+            if (item.is_regular_file() && !stamps.count(path))
+            {
+                stamp(path);
+                addUnique(changed, path);
+            }
+        }
+    }
+
+    for (auto &entry : stamps)
+    {
+        auto time = std::filesystem::last_write_time(entry.first, error);
+        if (!error && time != entry.second)
+        {
+            entry.second = time;
+            addUnique(changed, entry.first);
+        }
+    }
+    return changed;
+}
+
+void FileWatcher::poll(std::vector<std::string> &changed)
+{
+    if (scan.valid())
+    {
+        if (scan.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return; // Still walking the trees
+        finishScan();
+        // The interval runs from the end of a scan, so a slow disk cannot
+        // keep the worker busy back to back
+        lastScan.restart();
+    }
+    for (const std::string &path : unreported)
+        addUnique(changed, path);
+    unreported.clear();
+
+    if (lastScan.getElapsedTime().asSeconds() < 0.5f)
+        return;
+    scan = std::async(std::launch::async, [this]
+                      { return rescan(); });
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SFML/System/Clock.hpp>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Reports files that were rewritten since the last poll. On Linux this is
+// inotify: directories are watched rather than files, because editors and
+// our own writers replace files by rename. Elsewhere it falls back to
+// comparing modification times, at most twice a second, on a worker thread
+// so that walking a large asset tree never stalls a frame.
+class FileWatcher
+{
+private:
+#if defined(__linux__)
+    struct Directory
+    {
+        std::string path;
+        bool wholeTree;
+        std::unordered_set<std::string> files; // Full paths, when not wholeTree
+    };
+
+    int fd;
+    std::unordered_map<int, Directory> directories;
+
+    int addDirectory(const std::string &path, bool wholeTree);
+#else
+    // Owned by the scan while one is in flight
+    std::unordered_map<std::string, std::filesystem::file_time_type> stamps;
+    std::vector<std::string> trees;
+    std::future<std::vector<std::string>> scan; // Changed paths
+    std::vector<std::string> unreported; // Found by a scan that watch*() waited for
+    sf::Clock lastScan;
+
+    void stamp(const std::string &path);
+    void finishScan();
+    std::vector<std::string> rescan();
+#endif
+
+public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    bool watchFile(const std::string &path);
+    bool watchTree(const std::string &directory);
+
+    // Non-blocking; appends each changed path once
+    void poll(std::vector<std::string> &changed);
+};
@@ -0,0 +1,221 @@
+#include "FrameCapture.h"
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+// Packs rows read back at 'pitch' bytes each and turns them top-down, in place.
+// Textures updated from a window hold their rows bottom-up.
+static void toTopDown(std::vector<std::uint8_t> &pixels, sf::Vector2u size, std::size_t pitch)
+{
+    std::size_t row = static_cast<std::size_t>(size.x) * 4;
+    if (pitch != row)
+        for (std::size_t y = 1; y < size.y; ++y)
+            std::copy_n(pixels.begin() + y * pitch, row, pixels.begin() + y * row);
+    for (std::size_t top = 0, bottom = size.y; top + 1 < bottom; ++top, --bottom)
+        std::swap_ranges(pixels.begin() + top * row, pixels.begin() + (top + 1) * row,
+                         pixels.begin() + (bottom - 1) * row);
+}
+
+// ============= FrameCapture Implementation =============
+
+FrameCapture::FrameCapture()
+    : ring{}, next(0), inFlight(0), screenshotNumber(1), streaming(false), freeBuffers(MaxQueued), busy(false),
+      stopping(false), streamed(0), dropped(0)
+{
+    worker = std::thread(&FrameCapture::workerLoop, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    flushRing();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queued.notify_all();
+    worker.join(); // Finishes the queue first
+}
+
+void FrameCapture::requestScreenshot()
+{
+    std::string path;
+    do
+        path = "screenshot-" + std::to_string(screenshotNumber++) + ".png";
+    while (std::filesystem::exists(path));
+    screenshotRequest = path;
+}
+
+bool FrameCapture::startStream(const std::string &path)
+{
+    if (streaming)
+        return false;
+    stream.open(path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        std::cerr << "Cannot write capture file " << path << "\n";
+        return false;
+    }
+    streamPath = path;
+    streamSize = {}; // Taken from the first frame
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        streamed = 0;
+        dropped = 0;
+    }
+    streaming = true;
+    streamClock.restart();
+    return true;
+}
+
+void FrameCapture::stopStream(std::ostream &out)
+{
+    if (!streaming)
+        return;
+    streaming = false;
+    float seconds = streamClock.getElapsedTime().asSeconds();
+    flushRing();
+    waitIdle();
+    stream.close();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    double fps = seconds > 0 ? static_cast<double>(streamed + dropped) / seconds : 0;
+    out << "Capture: " << streamed << " frames to " << streamPath << " (" << streamSize.x << "x" << streamSize.y
+        << " RGBA, " << fps << " fps), " << dropped << " dropped\n"
+        << "  ffmpeg -f rawvideo -pixel_format rgba -video_size " << streamSize.x << "x" << streamSize.y
+        << " -framerate " << static_cast<int>(fps + 0.5) << " -i " << streamPath << " capture.mp4\n";
+}
+
+void FrameCapture::capture(const sf::RenderWindow &window)
+{
+    if (inFlight == 0 && !streaming && screenshotRequest.empty())
+        return;
+
+    // This slot was filled RingSize frames ago, so reading it back does not
+    // wait for the GPU to catch up with the frame just drawn
+    Slot &slot = ring[next];
+    if (slot.stream || !slot.screenshotPath.empty())
+        readBack(slot);
+
+    if (streaming || !screenshotRequest.empty())
+    {
+        if (slot.texture.getSize() != window.getSize() && !slot.texture.resize(window.getSize()))
+        {
+            std::cerr << "Cannot create a capture texture\n";
+            screenshotRequest.clear();
+            return;
+        }
+        if (streaming && streamSize == sf::Vector2u())
+            streamSize = window.getSize();
+
+        slot.texture.update(window); // GPU to GPU copy of the back buffer
+        slot.screenshotPath = std::move(screenshotRequest);
+        screenshotRequest.clear();
+        slot.stream = streaming;
+        ++inFlight;
+    }
+    next = (next + 1) % RingSize;
+}
+
+void FrameCapture::readBack(Slot &slot)
+{
+    Job job{{}, slot.texture.getSize(), 0, std::move(slot.screenshotPath), slot.stream};
+    slot.screenshotPath.clear();
+    slot.stream = false;
+    --inFlight;
+
+    {
+        // Checked before the readback, so a dropped frame costs nothing
+        std::unique_lock<std::mutex> lock(mutex);
+        if (freeBuffers.empty() && job.stream)
+        {
+            ++dropped;
+            job.stream = false;
+        }
+        if (!job.stream && job.screenshotPath.empty())
+            return;
+        returned.wait(lock, [this]
+                      { return !freeBuffers.empty(); });
+        job.pixels = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+    }
+
+    // Read straight into the recycled buffer: copyToImage() allocates a new
+    // frame-sized image every time. The texture may be padded past its size.
+    GLint previous = 0, width = 0, height = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    glBindTexture(GL_TEXTURE_2D, slot.texture.getNativeHandle());
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    job.pitch = static_cast<std::size_t>(width) * 4;
+    job.pixels.resize(job.pitch * static_cast<std::size_t>(height));
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, job.pixels.data());
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    queued.notify_one();
+}
+
+void FrameCapture::flushRing()
+{
+    // Oldest first, so recorded frames stay in order
+    for (std::size_t i = 0; i < RingSize && inFlight > 0; ++i)
+    {
+        Slot &slot = ring[(next + i) % RingSize];
+        if (slot.stream || !slot.screenshotPath.empty())
+            readBack(slot);
+    }
+}
+
+void FrameCapture::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this]
+                 { return jobs.empty() && !busy; });
+}
+
+void FrameCapture::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        queued.wait(lock, [this]
+                    { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+            return; // Stopping, and everything queued is written
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+
+        toTopDown(job.pixels, job.size, job.pitch);
+        if (!job.screenshotPath.empty())
+        {
+            sf::Image image(job.size, job.pixels.data());
+            if (image.saveToFile(job.screenshotPath))
+                std::cout << "Saved " << job.screenshotPath << "\n";
+            else
+                std::cerr << "Cannot write " << job.screenshotPath << "\n";
+        }
+        bool written = false;
+        if (job.stream && job.size == streamSize)
+        {
+            stream.write(reinterpret_cast<const char *>(job.pixels.data()),
+                         static_cast<std::streamsize>(job.size.x) * job.size.y * 4);
+            written = static_cast<bool>(stream);
+        }
+
+        lock.lock();
+        busy = false;
+        freeBuffers.push_back(std::move(job.pixels));
+        returned.notify_one();
+        if (job.stream)
+            ++(written ? streamed : dropped);
+        if (jobs.empty())
+            drained.notify_all();
+    }
+}
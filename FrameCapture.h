@@ -0,0 +1,101 @@
+#pragma once
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Clock.hpp>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Screenshots and continuous recording without stalling the frame. The back
+// buffer is copied into a ring of textures on the GPU, which needs no sync;
+// a slot is only read back when the ring comes round to it again, by which
+// time the GPU finished it frames ago. The readback itself is still a
+// GPU-to-CPU copy on the main thread, into one of MaxQueued recycled
+// buffers. Row flipping, PNG encoding and file writes run on a worker, which
+// hands each buffer back when done: recorded frames that find no free buffer
+// are dropped and counted rather than waited for. Screenshots wait for one.
+class FrameCapture
+{
+public:
+    static constexpr std::size_t RingSize = 3;
+    static constexpr std::size_t MaxQueued = 8; // Frame buffers shared with the worker
+
+private:
+    struct Slot
+    {
+        sf::Texture texture;
+        std::string screenshotPath; // Empty: not a screenshot
+        bool stream;                // Part of the recording
+    };
+
+    struct Job
+    {
+        std::vector<std::uint8_t> pixels; // From 'freeBuffers'; rows bottom-up
+        sf::Vector2u size;
+        std::size_t pitch; // Bytes per row in 'pixels'
+        std::string screenshotPath;
+        bool stream;
+    };
+
+    std::array<Slot, RingSize> ring;
+    std::size_t next;     // Slot written this frame
+    std::size_t inFlight; // Slots waiting for readback
+    std::string screenshotRequest;
+    std::uint32_t screenshotNumber;
+
+    // Recording: raw RGBA frames of one size, back to back. Only the worker
+    // writes the file while it is open.
+    std::ofstream stream;
+    std::string streamPath;
+    sf::Vector2u streamSize;
+    bool streaming;
+    sf::Clock streamClock;
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable drained;
+    std::condition_variable returned; // A buffer went back to 'freeBuffers'
+    std::deque<Job> jobs;
+    std::vector<std::vector<std::uint8_t>> freeBuffers; // Keep their capacity between frames
+    bool busy; // The worker holds a job outside the lock
+    bool stopping;
+    std::uint64_t streamed, dropped; // Guarded by 'mutex'
+    std::thread worker;
+
+    void readBack(Slot &slot);
+    void flushRing();
+    void waitIdle();
+    void workerLoop();
+
+public:
+    FrameCapture();
+    // Writes out whatever is still in flight; needs the GL context, so
+    // destroy before the window
+    ~FrameCapture();
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Saves the next captured frame as screenshot-N.png, N the first free number
+    void requestScreenshot();
+
+    // Records every captured frame to 'path' until stopStream(). Frames are
+    // raw top-down RGBA at the window's current size; frames of any other
+    // size (after a resize) count as dropped.
+    bool startStream(const std::string &path);
+    // Finishes the file and prints a summary with the ffmpeg command to
+    // convert it
+    void stopStream(std::ostream &out);
+    bool isStreaming() const { return streaming; }
+
+    // After drawing and before display(). Costs nothing when idle.
+    void capture(const sf::RenderWindow &window);
+};
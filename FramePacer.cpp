@@ -0,0 +1,83 @@
+#include "FramePacer.h"
+#include <SFML/System/Sleep.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const sf::Time MinSpinMargin = sf::microseconds(200);
+const sf::Time MaxSpinMargin = sf::milliseconds(4);
+} // namespace
+
+// ============= FramePacer Implementation =============
+
+FramePacer::FramePacer(PacingMode pacing, int fpsCap)
+    : mode(pacing), interval(sf::seconds(1.0f / static_cast<float>(std::max(fpsCap, 1)))), spinMargin(sf::milliseconds(1)),
+      presents(0), meanMs(0), m2(0), minMs(0), maxMs(0), late(0) {}
+
+void FramePacer::apply(sf::Window &window) const
+{
+    window.setVerticalSyncEnabled(mode == PacingMode::VSync);
+    window.setFramerateLimit(0); // SFML's limiter is a bare sleep; this class does it
+}
+
+void FramePacer::wait()
+{
+    if (mode != PacingMode::Capped && mode != PacingMode::Sleep)
+        return;
+
+    deadline += interval;
+    sf::Time now = clock.getElapsedTime();
+    if (deadline <= now)
+    {
+        deadline = now; // Behind: do not try to catch up with a burst
+        return;
+    }
+
+    sf::Time wake = mode == PacingMode::Capped ? deadline - spinMargin : deadline;
+    if (wake > now)
+    {
+        sf::sleep(wake - now);
+        now = clock.getElapsedTime();
+        if (mode == PacingMode::Capped)
+        {
+            // Cover the latest recent wake-up; shrink slowly once they improve
+            sf::Time oversleep = now - wake;
+            spinMargin = std::clamp(std::max(oversleep * 1.25f, spinMargin - sf::microseconds(10)), MinSpinMargin,
+                                    MaxSpinMargin);
+        }
+    }
+    while (mode == PacingMode::Capped && clock.getElapsedTime() < deadline)
+    {
+    }
+}
+
+void FramePacer::presented()
+{
+    sf::Time now = clock.getElapsedTime();
+    if (lastPresent != sf::Time::Zero)
+    {
+        double ms = static_cast<double>((now - lastPresent).asMicroseconds()) / 1000.0;
+        ++presents;
+        double delta = ms - meanMs;
+        meanMs += delta / static_cast<double>(presents);
+        m2 += delta * (ms - meanMs);
+        minMs = presents == 1 ? ms : std::min(minMs, ms);
+        maxMs = presents == 1 ? ms : std::max(maxMs, ms);
+        if (ms > 1.5 * interval.asSeconds() * 1000.0)
+            ++late;
+    }
+    lastPresent = now;
+}
+
+void FramePacer::printStats(std::ostream &out) const
+{
+    static const char *const Names[] = {"vsync", "uncapped", "cap", "sleep"};
+    out << "Pacing (" << Names[static_cast<int>(mode)] << "): " << presents << " frames, present interval "
+        << meanMs << " ms avg, " << (presents > 1 ? std::sqrt(m2 / static_cast<double>(presents - 1)) : 0.0)
+        << " ms stddev, " << minMs << " / " << maxMs << " ms min / max";
+    if (mode == PacingMode::Capped || mode == PacingMode::Sleep)
+        out << ", " << late << " over 1.5x the " << interval.asSeconds() * 1000.0f << " ms target"
+            << ", spin margin " << spinMargin.asMicroseconds() << " us";
+    out << "\n";
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/Window/Window.hpp>
+#include <cstdint>
+#include <ostream>
+#include "PacingMode.h"
+
+// Paces the main loop and measures how evenly frames are presented. A plain
+// sleep wakes late by up to the OS timer granularity (about 1 ms on Linux,
+// up to 15.6 ms on Windows), so Capped sleeps until a margin before the
+// deadline and spins on the clock for the rest. The margin follows how late
+// sleeps actually wake.
+class FramePacer
+{
+private:
+    PacingMode mode;
+    sf::Time interval;
+    sf::Clock clock;
+    sf::Time deadline;
+    sf::Time spinMargin;
+
+    // Present statistics: time between the ends of consecutive display()
+    // calls, accumulated with Welford's method
+    sf::Time lastPresent;
+    std::uint64_t presents;
+    double meanMs, m2, minMs, maxMs;
+    std::uint64_t late; // Intervals over 1.5x the target (capped modes)
+
+public:
+    FramePacer(PacingMode pacing, int fpsCap);
+
+    // Vsync on or off to match the mode
+    void apply(sf::Window &window) const;
+
+    // Right before display(), where vsync would block too, so the time
+    // spent simulating and drawing does not show up as present jitter
+    void wait();
+    // Right after display()
+    void presented();
+
+    PacingMode getMode() const { return mode; }
+    void printStats(std::ostream &out) const;
+};
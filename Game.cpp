@@ -1,41 +1,253 @@
 #include "Game.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
 #include <cmath>
 #include <optional>
 
-// SFML 3.x: Window constructor uses an initializer list for settings
-Game::Game() : window({{800, 600}, "2D Shooter - OOP Project (SFML 3.x)"})
+namespace
 {
-    window.setVerticalSyncEnabled(true);
+// Level parse plus wall/destructible construction; chunked levels only need
+// the level, their objects come from the streamer
+StaticLayer loadStartupLayer(const std::string &path)
+{
+    std::shared_ptr<const Level> loaded = loadLevelOrBuiltin(path);
+    if (!loaded || loaded->isChunked())
+        return StaticLayer{std::move(loaded), {}, {}};
+    return StaticLayer::build(std::move(loaded));
+}
+} // namespace
+
+Game::Game(const GameOptions &options)
+    : startupReport(options.startupReport), firstFrame(true),
+      startupLayer(std::async(std::launch::async, [this, path = options.levelPath]
+                              {
+                                  StartupTimeline::Scope scope = startup.measure("load level", true);
+                                  return loadStartupLayer(path); })),
+      startupSprites(std::async(std::launch::async, [this, pack = options.assetArchive, root = options.assetRoot]
+                                {
+                                    StartupTimeline::Scope scope = startup.measure("decode sprites", true);
+                                    if (!pack.empty())
+                                        archive.open(pack);
+                                    const AssetArchive *source = archive.isOpen() ? &archive : nullptr;
+                                    return TextureAtlas::pack([&](const std::string &name)
+                                                              { return openAssetSource(source, root, name); }); })),
+      window(createWindow()),
+      level(awaitLevel()),
+      streamer(createChunkStreamer(level, options.chunkCacheMb)),
+      world(level ? std::move(loadedLayer) : StaticLayer::build(Level::builtin()), streamer.get()),
+      camera(sf::Vector2<float>(window.getSize())),
+      assetReportPending(options.assetReport),
+      queue(atlas), batch(atlas, window), tiles(atlas), destructibles(atlas), fogOfWar(options.fogOfWar),
+      score(0), frameTimeSum(0), frameTimeMax(0), frameCount(0),
+      hotReload(!options.isLockstep() && options.recordPath.empty()), watching(false),
+      levelPath(options.levelPath),
+      assetRoot(std::filesystem::path(options.assetRoot).lexically_normal().generic_string()),
+      savePath(options.savePath), saveAllowed(!options.isLockstep() && options.recordPath.empty() && !streamer),
+      rewinding(false),
+      pacer(options.pacing, options.fpsCap),
+      fixedStep(options.fixedStep), accumulator(0)
+{
+    if (!level)
+        window.close(); // loadLevelOrBuiltin already reported why
+    camera.setBounds(world.getLevel().getBounds());
+
+    {
+        StartupTimeline::Scope scope = startup.measure("wait for sprites");
+        AtlasLayout sprites = startupSprites.get();
+        if (!options.assetArchive.empty() && !archive.isOpen())
+            window.close(); // open() already reported why
+
+        StartupTimeline::Scope upload = startup.measure("context setup + texture upload");
+        pacer.apply(window);
+        assets = std::make_unique<AssetManager>(archive.isOpen() ? &archive : nullptr, options.assetRoot);
+        if (!atlas.upload(sprites))
+            window.close();
+        batch.enableDiscShader(); // Falls back to atlas discs without geometry shaders
+        particles.createRenderer();
+        hud.setFont(assets->loadFont("fonts/hud.ttf"));
+        hud.setStyle(Hud::Field::Health, {10, 8}, sf::Color(120, 220, 120));
+        hud.setStyle(Hud::Field::Score, {10, 28}, sf::Color::White);
+        hud.setStyle(Hud::Field::FrameTime, {10, 48}, sf::Color(200, 200, 200));
+    }
+    if (options.isLockstep() && !startLockstep(options))
+        window.close();
+    if (!options.recordPath.empty() && !recorder.open(options.recordPath))
+        window.close();
+    if (!options.capturePath.empty() && !frameCapture.startStream(options.capturePath))
+        window.close();
+    if (fogOfWar && window.getSettings().stencilBits == 0)
+    {
+        std::cerr << "No stencil buffer; fog of war disabled\n";
+        fogOfWar = false;
+    }
+
+    if (saveAllowed && options.rewindSeconds > 0)
+    {
+        auto ticks = static_cast<std::uint32_t>(options.rewindSeconds / World::FixedDt);
+        rewind = std::make_unique<RewindBuffer>(RewindBudgetBytes, ticks);
+    }
+
+}
+
+sf::RenderWindow Game::createWindow()
+{
+    // Also creates the GL context, which is most of the cost. The stencil
+    // buffer is for the fog of war mask.
+    StartupTimeline::Scope scope = startup.measure("create window");
+    sf::ContextSettings settings;
+    settings.stencilBits = 8;
+    return sf::RenderWindow(sf::VideoMode({800, 600}), "2D Shooter - OOP Project (SFML 3.x)", sf::Style::Default,
+                            sf::State::Windowed, settings);
+}
+
+std::shared_ptr<const Level> Game::awaitLevel()
+{
+    StartupTimeline::Scope scope = startup.measure("wait for level");
+    loadedLayer = startupLayer.get();
+    return loadedLayer.level;
+}
+
+bool Game::startLockstep(const GameOptions &options)
+{
+    auto udp = std::make_unique<UdpTransport>();
+    int peer = options.lockstepHostPort != 0 ? 0 : 1;
+
+    if (!udp->bind(peer == 0 ? options.lockstepHostPort : sf::Socket::AnyPort))
+    {
+        std::cerr << "Lockstep: cannot bind UDP port\n";
+        return false;
+    }
+    lockstep = std::make_unique<LockstepSession>(applyConditions(std::move(udp), options.net), peer);
+
+    if (peer == 1)
+    {
+        std::optional<sf::IpAddress> host = sf::IpAddress::resolve(options.lockstepJoinHost);
+        if (!host)
+        {
+            std::cerr << "Lockstep: cannot resolve " << options.lockstepJoinHost << "\n";
+            return false;
+        }
+        lockstep->setRemote(*host, options.lockstepJoinPort);
+    }
+    return true;
+}
+
+void Game::startWatching()
+{
+    StartupTimeline::Scope scope = startup.measure("watch for changes");
+    if (!levelPath.empty() && !streamer) // A streamed level would need a new streamer
+        watcher.watchFile(levelPath);
+    watcher.watchTree(assetRoot);
+    watching = true;
+}
+
+void Game::pollReload()
+{
+    std::vector<std::string> changed;
+    watcher.poll(changed);
+
+    for (const std::string &path : changed)
+    {
+        std::error_code error;
+        if (!levelPath.empty() && std::filesystem::equivalent(path, levelPath, error))
+        {
+            if (!pendingLayer.valid()) // A save during a rebuild is picked up by the next event
+                pendingLayer = std::async(std::launch::async, [path = levelPath]
+                                          {
+                                              std::shared_ptr<const Level> fresh = loadLevelOrBuiltin(path);
+                                              return fresh ? StaticLayer::build(std::move(fresh)) : StaticLayer(); });
+            continue;
+        }
 
-    player = std::make_unique<Player>(400, 300);
+        std::string name = std::filesystem::path(path).lexically_relative(assetRoot).generic_string();
+        if (!name.empty() && name.compare(0, 2, "..") != 0)
+            assets->reload(name);
+    }
 
-    walls.push_back(std::make_unique<Wall>(0, 0, 800, 20));
-    walls.push_back(std::make_unique<Wall>(0, 580, 800, 20));
-    walls.push_back(std::make_unique<Wall>(0, 0, 20, 600));
-    walls.push_back(std::make_unique<Wall>(780, 0, 20, 600));
-    walls.push_back(std::make_unique<Wall>(200, 200, 100, 20));
-    walls.push_back(std::make_unique<Wall>(500, 400, 20, 150));
+    if (pendingLayer.valid() && pendingLayer.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        StaticLayer layer = pendingLayer.get();
+        if (!layer.level)
+            return; // Parse error already reported; keep playing the old level
 
-    destructibles.push_back(std::make_unique<DestructibleObject>(300, 300, 40, 40, 100));
-    destructibles.push_back(std::make_unique<DestructibleObject>(600, 200, 40, 40, 100));
+        level = layer.level;
+        world.swapStaticLayer(layer);
+        if (rewind)
+            rewind->clear(); // Its snapshots hold the old level's walls and destructibles
+        camera.setBounds(level->getBounds());
+        std::cout << "Reloaded " << levelPath << "\n";
+        // Assigning over a pending future would block on it, so each one is
+        // kept until it is done
+        std::erase_if(retiredLayers, [](const std::future<void> &retired)
+                      { return retired.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+        retiredLayers.push_back(std::async(std::launch::async, [old = std::move(layer)]() mutable
+                                           { old = StaticLayer(); }));
+    }
+}
+
+void Game::quickSave()
+{
+    sf::Clock timer;
+    world.saveSnapshot(snapshot);
+    float captureMs = timer.getElapsedTime().asSeconds() * 1000.0f;
+    if (snapshot.writeFile(savePath))
+        std::cout << "Saved " << savePath << " (" << snapshot.getSize() << " bytes, captured in "
+                  << captureMs << " ms)\n";
+}
 
-    enemies.push_back(std::make_unique<Enemy>(200, 100, player.get()));
-    enemies.push_back(std::make_unique<Enemy>(600, 500, player.get()));
+void Game::quickLoad()
+{
+    if (snapshot.loadFromFile(savePath) && world.loadSnapshot(snapshot))
+        std::cout << "Loaded " << savePath << " at tick " << world.getTick() << "\n";
 }
 
 void Game::run()
 {
     while (window.isOpen())
     {
-        float dt = clock.restart().asSeconds();
-        dt = std::min(dt, 0.05f);
+        float frameSeconds = clock.restart().asSeconds();
+        float dt = std::min(frameSeconds, 0.05f);
+
+        if (watching)
+            pollReload();
+        assets->pump();
+        if (assetReportPending && assets->isIdle())
+        {
+            assets->printReport(std::cout);
+            assetReportPending = false;
+        }
 
         handleEvents();
-        update(dt);
+        if (fixedStep)
+            updateFixed(dt);
+        else
+            update(dt);
+        particles.update(dt);
+        updateHud(frameSeconds);
         render();
+
+        if (firstFrame)
+        {
+            firstFrame = false;
+            startup.add("first frame", false, startup.now(), startup.now());
+            // Registering a large asset tree is not needed to show anything.
+            // Lockstep peers and recordings need the geometry to stay fixed,
+            // so never reload there.
+            if (hotReload)
+                startWatching();
+            if (startupReport)
+                startup.print(std::cout);
+        }
     }
+
+    recorder.close(world.checksum());
+    frameCapture.stopStream(std::cout);
+    pacer.printStats(std::cout);
+    if (streamer)
+        streamer->printStats(std::cout);
 }
 
 void Game::handleEvents()
@@ -47,136 +259,193 @@ void Game::handleEvents()
         if (event->is<sf::Event::Closed>())
             window.close();
 
+        // Show more of the world rather than stretching it
+        if (const auto *resized = event->getIf<sf::Event::Resized>())
+            camera.setSize(sf::Vector2<float>(resized->size));
+
+        if (const auto *key = event->getIf<sf::Event::KeyPressed>())
+        {
+            if (saveAllowed && key->code == sf::Keyboard::Key::F5)
+                quickSave();
+            else if (saveAllowed && key->code == sf::Keyboard::Key::F9)
+                quickLoad();
+            else if (key->code == sf::Keyboard::Key::F12)
+                frameCapture.requestScreenshot();
+        }
+
         // SFML 3.x: Get event data with getIf<T>()
         if (const auto *mouseButton = event->getIf<sf::Event::MouseButtonPressed>())
         {
             // SFML 3.x: Mouse buttons are in an enum class sf::Mouse::Button
             if (mouseButton->button == sf::Mouse::Button::Left)
             {
-                if (player->tryShoot())
-                {
-                    sf::Vector2<float> pPos = player->getPosition();
-                    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-
-                    float dx = static_cast<float>(mousePos.x) - (pPos.x + 15);
-                    float dy = static_cast<float>(mousePos.y) - (pPos.y + 15);
-
-                    projectiles.push_back(
-                        std::make_unique<Projectile>(pPos.x + 15, pPos.y + 15, dx, dy));
-                }
+                sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+                input.shoot = true;
+                input.aim = window.mapPixelToCoords(mousePos); // World space, the view may scroll
             }
         }
     }
 }
 
-void Game::update(float dt)
+void Game::sampleKeyboard()
 {
-    player->handleInput(dt);
-    player->update(dt);
-
-    for (auto &enemy : enemies)
-        enemy->update(dt);
-    for (auto &proj : projectiles)
-        proj->update(dt);
-    for (auto &dest : destructibles)
-        dest->update(dt);
+    // SFML 3.x: Keyboard keys are now in an enum class sf::Keyboard::Key
+    input.up = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W);
+    input.down = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S);
+    input.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A);
+    input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D);
+    rewinding = rewind && sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Backspace);
+}
 
-    handleCollisions();
-    cleanupInactive();
+void Game::consumeWorldEvents()
+{
+    tiles.invalidate(world.getStaticChanges());
+    destructibles.apply(world);
+    for (const WorldEvent &event : world.getEvents())
+    {
+        switch (event.type)
+        {
+        case WorldEvent::Type::Shot:
+            particles.emit(EffectType::MuzzleFlash, event.position, event.direction);
+            break;
+        case WorldEvent::Type::Hit:
+            particles.emit(EffectType::Sparks, event.position, event.direction);
+            break;
+        case WorldEvent::Type::EnemyKilled:
+            particles.emit(EffectType::EnemyDebris, event.position, event.direction);
+            score += EnemyPoints;
+            break;
+        case WorldEvent::Type::DestructibleDestroyed:
+            particles.emit(EffectType::Sparks, event.position, event.direction);
+            particles.emit(EffectType::WoodDebris, event.position);
+            score += DestructiblePoints;
+            break;
+        }
+    }
 }
 
-void Game::render()
+void Game::updateHud(float frameSeconds)
 {
-    window.clear(sf::Color(50, 50, 50));
+    // Formatted into a stack buffer; the HUD only lays out what changed
+    char text[64];
+    std::snprintf(text, sizeof(text), "HP %d", static_cast<int>(std::ceil(world.getPlayer().getHealth())));
+    hud.setText(Hud::Field::Health, text);
+    std::snprintf(text, sizeof(text), "Score %u", static_cast<unsigned int>(score));
+    hud.setText(Hud::Field::Score, text);
 
-    for (auto &wall : walls)
-        wall->render(window);
-    for (auto &dest : destructibles)
-        dest->render(window);
-    player->render(window);
-    for (auto &enemy : enemies)
-        enemy->render(window);
-    for (auto &proj : projectiles)
-        proj->render(window);
+    frameTimeSum += frameSeconds;
+    frameTimeMax = std::max(frameTimeMax, frameSeconds);
+    ++frameCount;
+    if (frameStatsClock.getElapsedTime().asSeconds() >= 0.5f)
+    {
+        float average = frameTimeSum / static_cast<float>(frameCount);
+        std::snprintf(text, sizeof(text), "%.0f fps  %.2f ms avg  %.2f ms max", 1.0f / average, average * 1000.0f,
+                      frameTimeMax * 1000.0f);
+        hud.setText(Hud::Field::FrameTime, text);
+        frameTimeSum = frameTimeMax = 0;
+        frameCount = 0;
+        frameStatsClock.restart();
+    }
+}
 
-    window.display();
+void Game::update(float dt)
+{
+    sampleKeyboard();
+    world.update(input, dt);
+    consumeWorldEvents();
+
+    // A click only fires on the tick it was seen
+    input.shoot = false;
 }
 
-void Game::handleCollisions()
+void Game::updateFixed(float frameDt)
 {
-    // Player vs walls
-    for (auto &wall : walls)
+    sampleKeyboard();
+    accumulator += frameDt;
+
+    if (rewinding)
     {
-        if (wall->getActive())
+        // One tick back per frame; the history newer than where we stop is
+        // dropped by the next record()
+        if (world.getTick() <= rewind->getOldestTick() || rewind->restore(world, world.getTick() - 1))
         {
-            sf::Rect<float> pBounds = player->getBounds();
-            sf::Rect<float> wBounds = wall->getBounds();
-
-            // SFML 3.x: findIntersection returns an optional
-            if (const auto intersection = pBounds.findIntersection(wBounds))
-            {
-                sf::Vector2<float> pPos = player->getPosition();
-                float overlapX = intersection->size.x;
-                float overlapY = intersection->size.y;
-
-                if (overlapX < overlapY)
-                {
-                    if (pBounds.position.x < wBounds.position.x)
-                        pPos.x -= overlapX;
-                    else
-                        pPos.x += overlapX;
-                }
-                else
-                {
-                    if (pBounds.position.y < wBounds.position.y)
-                        pPos.y -= overlapY;
-                    else
-                        pPos.y += overlapY;
-                }
-                player->setPosition(pPos); // Update player position
-            }
+            accumulator = 0;
+            return;
         }
+        // A hole or a state the world cannot load: the history is no use,
+        // so drop it and carry on simulating
+        std::cerr << "Rewind: cannot restore tick " << world.getTick() - 1 << "\n";
+        rewind->clear();
+        rewinding = false;
     }
 
-    // Projectiles vs entities
-    for (auto &proj : projectiles)
+    while (accumulator >= World::FixedDt)
     {
-        if (!proj->getActive())
-            continue;
-
-        // vs enemies
-        for (auto &enemy : enemies)
+        bool inputTaken = true;
+        if (lockstep)
         {
-            if (enemy->getActive() && proj->getBounds().intersects(enemy->getBounds()))
+            // Refused while we are InputDelay ticks ahead; the tick below
+            // then runs an input pushed earlier, so a click stays latched
+            inputTaken = lockstep->pushLocalInput(input);
+            lockstep->poll();
+            if (!lockstep->canAdvance())
             {
-                proj->setActive(false);
-                enemy->setActive(false);
+                // Waiting on the peer: do not bank time we cannot simulate yet
+                accumulator = std::min(accumulator, World::FixedDt);
                 break;
             }
+            PlayerInput tickInput = lockstep->takeTickInput();
+            recorder.record(tickInput);
+            world.update(tickInput, World::FixedDt);
+            consumeWorldEvents();
+            lockstep->recordChecksum(world.getTick() - 1, world.checksum());
         }
-
-        if (!proj->getActive())
-            continue; // Check again in case it hit an enemy
-
-        // vs destructibles
-        for (auto &dest : destructibles)
+        else
         {
-            if (dest->getActive() && proj->getBounds().intersects(dest->getBounds()))
-            {
-                proj->setActive(false);
-                dest->takeDamage(25.0f);
-                break;
-            }
+            if (rewind)
+                rewind->record(world, input);
+            recorder.record(input);
+            world.update(input, World::FixedDt);
+            consumeWorldEvents();
         }
+
+        if (inputTaken)
+            input.shoot = false;
+        accumulator -= World::FixedDt;
     }
+
+    // Keep the link alive (acks, resends) on frames that simulate nothing
+    if (lockstep)
+        lockstep->poll();
 }
 
-void Game::cleanupInactive()
+void Game::render()
 {
-    std::erase_if(projectiles, [](const auto &p)
-                  { return !p->getActive(); });
-    std::erase_if(enemies, [](const auto &e)
-                  { return !e->getActive(); });
-    std::erase_if(destructibles, [](const auto &d)
-                  { return !d->getActive(); });
-}
\ No newline at end of file
+    window.clear(sf::Color(50, 50, 50));
+
+    // Levels larger than the window scroll with the player
+    camera.follow(world.getPlayer().getBounds().getCenter());
+    window.setView(camera.getView());
+    sf::Rect<float> visible = camera.getVisibleArea();
+    if (!tiles.draw(window, world, visible))
+    {
+        world.renderWalls(queue, visible);
+        queue.flush(batch, RenderLayer::Static); // Under the destructibles
+    }
+    if (!destructibles.draw(window, world))
+        world.renderDestructibles(queue, visible);
+    world.renderDynamic(queue, visible);
+    queue.flush(batch, RenderLayer::Projectiles);
+    particles.draw(window, visible);
+    if (fogOfWar)
+    {
+        sight.update(world, world.getPlayer().getBounds().getCenter(), visible);
+        sight.drawFog(window, sf::Color(0, 0, 0, 200));
+    }
+    queue.flush(batch);
+    hud.draw(window);
+    frameCapture.capture(window);
+    pacer.wait();
+    window.display();
+    pacer.presented();
+}
@@ -2,31 +2,119 @@
 
 #include <SFML/Graphics/Graphics.hpp>
 #include <SFML/System/Clock.hpp>
-#include <vector>
+#include <future>
 #include <memory>
-#include "Entity.h"
-#include "Projectile.h"
-#include "StaticObject.h"
+#include <vector>
+#include "AssetManager.h"
+#include "Camera.h"
+#include "DestructibleBuffer.h"
+#include "FileWatcher.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
+#include "Hud.h"
+#include "InputLog.h"
+#include "Lockstep.h"
+#include "Options.h"
+#include "ParticleSystem.h"
+#include "Rewind.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+#include "StartupTimeline.h"
+#include "StaticTileCache.h"
+#include "Visibility.h"
+#include "World.h"
 
 class Game
 {
 private:
+    // Startup: the level and the sprite images are decoded on workers while
+    // the window and GL context are created. These members come first so the
+    // tasks are already running when 'window' is constructed.
+    StartupTimeline startup;
+    bool startupReport;
+    bool firstFrame;
+    AssetArchive archive; // Opened by the sprite task
+    std::future<StaticLayer> startupLayer;
+    std::future<AtlasLayout> startupSprites;
+    StaticLayer loadedLayer; // Moved into 'world' once the task finishes
+
     sf::RenderWindow window;
-    std::unique_ptr<Player> player;
-    std::vector<std::unique_ptr<Enemy>> enemies;
-    std::vector<std::unique_ptr<Projectile>> projectiles;
-    std::vector<std::unique_ptr<Wall>> walls;
-    std::vector<std::unique_ptr<DestructibleObject>> destructibles;
+    std::shared_ptr<const Level> level;
+    std::unique_ptr<ChunkStreamer> streamer; // Chunked levels only; declared before 'world', which uses it
+    World world;
+    Camera camera;
+    PlayerInput input;
+
+    std::unique_ptr<AssetManager> assets; // Declared after 'archive', which it reads from
+    bool assetReportPending;
+
+    // Objects record into 'queue'; 'batch' submits it sorted, one draw call
+    // per atlas page and blend mode
+    TextureAtlas atlas;
+    RenderQueue queue; // Declared after 'atlas', which both read from
+    SpriteBatch batch;
+    ParticleSystem particles; // Fed from world events, drawn over the projectiles
+    StaticTileCache tiles; // Walls, redrawn only where they change
+    DestructibleBuffer destructibles; // Patched per damaged object, drawn over the walls
+    FrameCapture frameCapture; // F12 screenshots and --capture; declared after 'window', whose context it uses
+    VisibilityPolygon sight; // Line of sight from the player, drawn as a stencil mask
+    bool fogOfWar;
+
+    // HUD: the score is cosmetic, counted from world events like the
+    // particles. Frame times are averaged over a short window for display.
+    static constexpr std::uint32_t EnemyPoints = 100;
+    static constexpr std::uint32_t DestructiblePoints = 25;
+    Hud hud;
+    std::uint32_t score;
+    sf::Clock frameStatsClock;
+    float frameTimeSum, frameTimeMax;
+    std::uint32_t frameCount;
+
+    // Hot reload: a changed level is rebuilt on a worker and swapped in
+    // between ticks; the replaced layer is freed on another worker
+    FileWatcher watcher;
+    bool hotReload;
+    bool watching; // Directories are only registered after the first frame
+    std::string levelPath;
+    std::string assetRoot;
+    std::future<StaticLayer> pendingLayer;
+    std::vector<std::future<void>> retiredLayers; // Still being freed; reaped once ready
+
+    // Quicksave: F5 writes, F9 restores (not while the tick stream is shared)
+    std::string savePath;
+    bool saveAllowed;
+    WorldSnapshot snapshot;
+
+    // Debug rewind, shares the quicksave restrictions
+    static constexpr std::size_t RewindBudgetBytes = 32 * 1024 * 1024;
+    std::unique_ptr<RewindBuffer> rewind;
+    bool rewinding;
 
     sf::Clock clock;
+    FramePacer pacer;
+
+    // Fixed-step / lockstep state
+    bool fixedStep;
+    float accumulator;
+    std::unique_ptr<LockstepSession> lockstep;
+    InputRecorder recorder;
 
-    void handleCollisions();
-    void cleanupInactive();
+    sf::RenderWindow createWindow();
+    std::shared_ptr<const Level> awaitLevel();
+    bool startLockstep(const GameOptions &options);
+    void startWatching();
+    void pollReload();
+    void quickSave();
+    void quickLoad();
     void handleEvents();
+    void sampleKeyboard();
+    void consumeWorldEvents();
+    void updateHud(float frameSeconds);
     void update(float dt);
+    void updateFixed(float frameDt);
     void render();
 
 public:
-    Game();
+    explicit Game(const GameOptions &options);
     void run();
-};
\ No newline at end of file
+};
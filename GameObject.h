@@ -2,8 +2,12 @@
 
 // SFML 3.x uses a different header structure
 #include <SFML/Graphics/Graphics.hpp>
+#include <cstdint>
 #include <memory>
 #include <vector>
+#include "SnapshotFormat.h"
+#include "RenderQueue.h"
+#include "StateHash.h"
  
 // Abstract base class for all game objects
 class GameObject
@@ -12,6 +16,7 @@ protected:
     sf::Vector2<float> position;
     sf::Vector2<float> size;
     bool isActive;
+    std::uint32_t id; // Stable per-world id, assigned by World on spawn
 
 public:
     GameObject(float x, float y, float w, float h);
@@ -19,7 +24,17 @@ public:
 
     // Pure virtual functions (must be implemented by derived classes)
     virtual void update(float dt) = 0;
-    virtual void render(sf::RenderWindow &window) = 0;
+    virtual void render(RenderQueue &queue) const = 0;
+
+    // Atlas sprite this object is drawn with
+    virtual SpriteId getSprite() const { return SpriteId::Flat; }
+
+    // Feeds every field that influences future ticks into the hash
+    virtual void hashState(StateHash &hash) const;
+
+    // Flat copies for snapshots; each subclass adds its own record
+    void saveState(ObjectRecord &record) const;
+    void loadState(const ObjectRecord &record);
 
     // SFML 3.x: sf::FloatRect is now sf::Rect<float>
     virtual sf::Rect<float> getBounds() const
@@ -30,6 +45,8 @@ public:
     bool getActive() const { return isActive; }
     void setActive(bool active) { isActive = active; }
     sf::Vector2<float> getPosition() const { return position; }
+    std::uint32_t getId() const { return id; }
+    void setId(std::uint32_t newId) { id = newId; }
 
     // Added to allow collision response to update position
     void setPosition(const sf::Vector2<float> &newPos) { position = newPos; }
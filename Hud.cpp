@@ -0,0 +1,114 @@
+#include "Hud.h"
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/View.hpp>
+
+// ============= Hud Implementation =============
+
+Hud::Hud(unsigned int size) : characterSize(size), runs{}, page(nullptr), lastLayouts(0)
+{
+    for (Run &run : runs)
+    {
+        run.color = sf::Color::White;
+        run.dirty = false;
+    }
+}
+
+void Hud::setFont(FontHandle handle)
+{
+    font = std::move(handle);
+    page = nullptr; // Lay everything out again on the next draw
+}
+
+void Hud::setText(Field field, std::string_view text)
+{
+    Run &run = runs[static_cast<std::size_t>(field)];
+    if (run.text == text)
+        return;
+    run.text = text;
+    run.dirty = true;
+}
+
+void Hud::setStyle(Field field, sf::Vector2<float> position, sf::Color color)
+{
+    Run &run = runs[static_cast<std::size_t>(field)];
+    run.position = position;
+    run.color = color;
+    run.dirty = true;
+}
+
+void Hud::layout(Run &run, const sf::Font &face)
+{
+    run.quads.clear();
+    float x = 0, baseline = static_cast<float>(characterSize);
+    char32_t previous = 0;
+
+    for (char c : run.text)
+    {
+        auto code = static_cast<char32_t>(static_cast<unsigned char>(c)); // HUD strings are ASCII
+        x += face.getKerning(previous, code, characterSize);
+        previous = code;
+
+        const sf::Glyph &glyph = face.getGlyph(code, characterSize, false);
+        if (glyph.textureRect.size.x > 0 && glyph.textureRect.size.y > 0)
+        {
+            sf::Vector2<float> p0(x + glyph.bounds.position.x, baseline + glyph.bounds.position.y);
+            sf::Vector2<float> p1 = p0 + glyph.bounds.size;
+            sf::Vector2<float> t0(glyph.textureRect.position), t1(glyph.textureRect.position + glyph.textureRect.size);
+
+            run.quads.push_back({p0, run.color, t0});
+            run.quads.push_back({{p1.x, p0.y}, run.color, {t1.x, t0.y}});
+            run.quads.push_back({{p0.x, p1.y}, run.color, {t0.x, t1.y}});
+            run.quads.push_back({{p0.x, p1.y}, run.color, {t0.x, t1.y}});
+            run.quads.push_back({{p1.x, p0.y}, run.color, {t1.x, t0.y}});
+            run.quads.push_back({p1, run.color, t1});
+        }
+        x += glyph.advance;
+    }
+    run.dirty = false;
+    ++lastLayouts;
+}
+
+void Hud::draw(sf::RenderTarget &target)
+{
+    lastLayouts = 0;
+    if (!font.isReady())
+        return;
+
+    // A hot-reloaded font keeps its address but not its glyph page
+    const sf::Font &face = font.get();
+    const sf::Texture *current = &face.getTexture(characterSize);
+    bool rebuild = current != page;
+    for (Run &run : runs)
+    {
+        if (run.dirty || current != page)
+        {
+            layout(run, face);
+            rebuild = true;
+        }
+    }
+    // Laying out new glyphs may have moved them to a grown page
+    page = &face.getTexture(characterSize);
+
+    if (rebuild)
+    {
+        vertices.clear();
+        for (const Run &run : runs)
+        {
+            for (sf::Vertex vertex : run.quads)
+            {
+                vertex.position += run.position;
+                vertices.push_back(vertex);
+            }
+        }
+    }
+    if (vertices.empty())
+        return;
+
+    // Pixels, whatever the camera is doing
+    sf::View world = target.getView();
+    target.setView(sf::View(sf::Rect<float>({0, 0}, sf::Vector2<float>(target.getSize()))));
+    sf::RenderStates states;
+    states.texture = page;
+    target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, states);
+    target.setView(world);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AssetManager.h"
+
+// Screen-space text overlay. Each field keeps its laid-out glyph quads and is
+// only laid out again when its string changes, so a HUD whose values are
+// steady costs one draw call and no glyph lookups per frame. All fields share
+// the font's glyph page and are drawn together.
+class Hud
+{
+public:
+    enum class Field : std::uint8_t
+    {
+        Health,
+        Score,
+        FrameTime,
+        Count
+    };
+
+private:
+    struct Run
+    {
+        std::string text;
+        sf::Vector2<float> position; // Top-left, in pixels
+        sf::Color color;
+        std::vector<sf::Vertex> quads; // Triangles, relative to 'position'
+        bool dirty;
+    };
+
+    FontHandle font; // Draws nothing until the font is ready
+    unsigned int characterSize;
+    std::array<Run, static_cast<std::size_t>(Field::Count)> runs;
+    std::vector<sf::Vertex> vertices; // Every run, rebuilt when one changes
+    const sf::Texture *page;          // Glyph page the quads point into
+    std::size_t lastLayouts;
+
+    void layout(Run &run, const sf::Font &face);
+
+public:
+    explicit Hud(unsigned int size = 16);
+
+    void setFont(FontHandle handle);
+    // Cheap when 'text' is unchanged; copies it otherwise
+    void setText(Field field, std::string_view text);
+    void setStyle(Field field, sf::Vector2<float> position, sf::Color color);
+
+    void draw(sf::RenderTarget &target);
+
+    // Fields laid out during the last draw(), for checking that steady
+    // values really are cached
+    std::size_t getLastLayouts() const { return lastLayouts; }
+};
@@ -0,0 +1,231 @@
+#include "InputLog.h"
+#include "NetProtocol.h"
+#include "World.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+constexpr char Magic[4] = {'S', 'I', 'N', 'P'};
+constexpr std::uint16_t Version = 1;
+constexpr std::uint8_t RepeatFlag = 0x80;
+constexpr std::uint8_t EndMarker = 0x60;
+constexpr std::uint8_t ShootBit = 16;
+
+template <typename T>
+void writeLE(std::ofstream &out, T value)
+{
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+    out.write(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+template <typename T>
+bool readLE(const std::vector<std::uint8_t> &data, std::size_t &cursor, T &value)
+{
+    if (cursor + sizeof(T) > data.size())
+        return false;
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, data.data() + cursor, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+    std::memcpy(&value, bytes, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+} // namespace
+
+// ============= InputRecorder Implementation =============
+
+bool InputRecorder::open(const std::string &path)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "Cannot write input log " << path << "\n";
+        return false;
+    }
+
+    file.write(Magic, sizeof(Magic));
+    writeLE<std::uint16_t>(file, Version);
+    writeLE<std::uint16_t>(file, 0);
+    writeLE<float>(file, World::FixedDt);
+
+    lastButtons = 0xFF; // Forces the first tick to be written in full
+    pendingRepeats = 0;
+    ticks = 0;
+    return true;
+}
+
+void InputRecorder::flushRepeats()
+{
+    if (pendingRepeats > 0)
+    {
+        file.put(static_cast<char>(RepeatFlag | pendingRepeats));
+        pendingRepeats = 0;
+    }
+}
+
+void InputRecorder::record(const PlayerInput &input)
+{
+    if (!file.is_open())
+        return;
+
+    std::uint8_t buttons = packButtons(input);
+    ++ticks;
+
+    if (!input.shoot && buttons == lastButtons)
+    {
+        if (++pendingRepeats == 0x7F)
+            flushRepeats();
+        return;
+    }
+
+    flushRepeats();
+    file.put(static_cast<char>(buttons));
+    if (input.shoot)
+    {
+        writeLE<float>(file, input.aim.x);
+        writeLE<float>(file, input.aim.y);
+    }
+
+    // A repeat never carries a shot, so remember the movement bits only
+    lastButtons = buttons & ~ShootBit;
+}
+
+void InputRecorder::close(std::uint64_t finalChecksum)
+{
+    if (!file.is_open())
+        return;
+
+    flushRepeats();
+    file.put(static_cast<char>(EndMarker));
+    writeLE<std::uint32_t>(file, ticks);
+    writeLE<std::uint64_t>(file, finalChecksum);
+    file.close();
+}
+
+// ============= InputPlayer Implementation =============
+
+bool InputPlayer::open(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Cannot read input log " << path << "\n";
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    cursor = 0;
+    std::uint16_t version = 0, reserved = 0;
+    if (data.size() < sizeof(Magic) || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+    {
+        std::cerr << path << " is not an input log\n";
+        return false;
+    }
+    cursor = sizeof(Magic);
+    if (!readLE(data, cursor, version) || !readLE(data, cursor, reserved) ||
+        !readLE(data, cursor, fixedDt) || version != Version)
+    {
+        std::cerr << path << ": unsupported input log version\n";
+        return false;
+    }
+
+    lastButtons = 0;
+    repeatsLeft = 0;
+    recordedTicks = 0;
+    recordedChecksum = 0;
+    hasFooter = false;
+    return true;
+}
+
+bool InputPlayer::next(PlayerInput &input)
+{
+    input = PlayerInput();
+
+    if (repeatsLeft > 0)
+    {
+        --repeatsLeft;
+        unpackButtons(lastButtons, input);
+        return true;
+    }
+
+    if (cursor >= data.size())
+        return false;
+
+    std::uint8_t byte = data[cursor++];
+    if (byte == EndMarker)
+    {
+        hasFooter = readLE(data, cursor, recordedTicks) && readLE(data, cursor, recordedChecksum);
+        cursor = data.size();
+        return false;
+    }
+
+    if (byte & RepeatFlag)
+    {
+        repeatsLeft = static_cast<std::uint8_t>((byte & 0x7F) - 1);
+        unpackButtons(lastButtons, input);
+        return true;
+    }
+
+    unpackButtons(byte, input);
+    if (input.shoot && !(readLE(data, cursor, input.aim.x) && readLE(data, cursor, input.aim.y)))
+        return false; // Truncated log
+    lastButtons = byte & ~ShootBit;
+    return true;
+}
+
+// ============= Headless replay =============
+
+int runReplay(const GameOptions &options)
+{
+    InputPlayer player;
+    if (!player.open(options.replayPath))
+        return 1;
+    if (player.getFixedDt() != World::FixedDt)
+    {
+        std::cerr << "Input log was recorded with a different fixed dt\n";
+        return 1;
+    }
+
+    std::shared_ptr<const Level> level = loadLevelOrBuiltin(options.levelPath);
+    if (!level)
+        return 1;
+
+    std::unique_ptr<ChunkStreamer> streamer = createChunkStreamer(level, options.chunkCacheMb);
+    World world(level, streamer.get());
+    PlayerInput input;
+    sf::Clock clock;
+
+    while (player.next(input))
+        world.update(input, World::FixedDt);
+
+    float seconds = clock.getElapsedTime().asSeconds();
+    std::uint64_t checksum = world.checksum();
+
+    std::cout << "Replayed " << world.getTick() << " ticks in " << seconds * 1000.0f << " ms ("
+              << (seconds > 0 ? world.getTick() / seconds : 0.0f) << " ticks/sec)\n"
+              << "Final checksum " << std::hex << checksum << std::dec << "\n";
+
+    if (!player.hasChecksum())
+    {
+        std::cout << "Log has no footer (recording was cut short); nothing to verify\n";
+        return 0;
+    }
+    if (player.getRecordedTicks() != world.getTick() || player.getRecordedChecksum() != checksum)
+    {
+        std::cout << "MISMATCH: recorded " << player.getRecordedTicks() << " ticks, checksum "
+                  << std::hex << player.getRecordedChecksum() << std::dec << "\n";
+        return 1;
+    }
+    std::cout << "Replay matches the recording\n";
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Options.h"
+#include "PlayerInput.h"
+
+// Compact binary log of the input applied on every fixed tick.
+//
+// Layout (little endian): "SINP", u16 version, u16 reserved, f32 fixed dt,
+// then one record per tick:
+//   0b000sRLDU         buttons; if s (shoot) is set, f32 aim x and y follow
+//   0b1nnnnnnn         previous buttons repeated n more ticks (no shoot)
+//   0x60               end marker: u32 tick count, u64 final World checksum
+// Held keys compress to one byte per 127 ticks; only clicks cost extra.
+class InputRecorder
+{
+private:
+    std::ofstream file;
+    std::uint8_t lastButtons;
+    std::uint8_t pendingRepeats;
+    std::uint32_t ticks;
+
+    void flushRepeats();
+
+public:
+    bool open(const std::string &path);
+    void record(const PlayerInput &input);
+    void close(std::uint64_t finalChecksum);
+    bool isOpen() const { return file.is_open(); }
+};
+
+class InputPlayer
+{
+private:
+    std::vector<std::uint8_t> data;
+    std::size_t cursor;
+    std::uint8_t lastButtons;
+    std::uint8_t repeatsLeft;
+    float fixedDt;
+    std::uint32_t recordedTicks;
+    std::uint64_t recordedChecksum;
+    bool hasFooter;
+
+public:
+    bool open(const std::string &path);
+
+    // False once the log is exhausted
+    bool next(PlayerInput &input);
+
+    float getFixedDt() const { return fixedDt; }
+    bool hasChecksum() const { return hasFooter; }
+    std::uint32_t getRecordedTicks() const { return recordedTicks; }
+    std::uint64_t getRecordedChecksum() const { return recordedChecksum; }
+};
+
+// Headless: replays options.replayPath as fast as possible, reports ticks/sec
+// and returns non-zero if the final state differs from the recording
+int runReplay(const GameOptions &options);
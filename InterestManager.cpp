@@ -0,0 +1,99 @@
+#include "InterestManager.h"
+#include <algorithm>
+#include <cmath>
+
+// ============= InterestManager Implementation =============
+
+InterestManager::InterestManager(float cellSize)
+    : grid(cellSize), nextClientId(1), tick(0) {}
+
+std::uint32_t InterestManager::addClient(float viewRadius, std::size_t budgetBytesPerTick)
+{
+    std::uint32_t id = nextClientId++;
+    Client &client = clients[id];
+    client.viewCenter = sf::Vector2<float>(0, 0);
+    client.viewRadius = viewRadius;
+    client.budgetBytes = budgetBytesPerTick;
+    return id;
+}
+
+void InterestManager::removeClient(std::uint32_t clientId) { clients.erase(clientId); }
+
+void InterestManager::setClientView(std::uint32_t clientId, const sf::Vector2<float> &center)
+{
+    auto it = clients.find(clientId);
+    if (it != clients.end())
+        it->second.viewCenter = center;
+}
+
+void InterestManager::beginTick(const std::vector<ReplicatedEntity> &worldEntities)
+{
+    ++tick;
+    entities = worldEntities;
+
+    // The grid stores indices into 'entities', not ids
+    grid.clear();
+    for (std::size_t i = 0; i < entities.size(); ++i)
+        grid.insert(static_cast<std::uint32_t>(i), entities[i].position);
+}
+
+const std::vector<std::uint32_t> &InterestManager::selectForClient(std::uint32_t clientId)
+{
+    static const std::vector<std::uint32_t> empty;
+    auto it = clients.find(clientId);
+    if (it == clients.end())
+        return empty;
+
+    Client &client = it->second;
+    client.selected.clear();
+    candidates.clear();
+    ranked.clear();
+
+    grid.queryCircle(client.viewCenter, client.viewRadius, candidates);
+
+    float radiusSq = client.viewRadius * client.viewRadius;
+    for (std::uint32_t index : candidates)
+    {
+        const ReplicatedEntity &e = entities[index];
+        sf::Vector2<float> d = e.position - client.viewCenter;
+        float distSq = d.x * d.x + d.y * d.y;
+        if (distSq > radiusSq)
+            continue;
+
+        // Linear falloff: full priority at the center, a quarter at the edge
+        float falloff = 1.0f - 0.75f * (std::sqrt(distSq) / client.viewRadius);
+
+        Accumulator &acc = client.accumulators[e.id];
+        if (acc.lastSeenTick != tick - 1)
+            acc.value = 0; // Newly relevant entity
+        acc.value += e.priority * falloff;
+        acc.lastSeenTick = tick;
+        ranked.emplace_back(acc.value, index);
+    }
+
+    std::sort(ranked.begin(), ranked.end(),
+              [](const auto &a, const auto &b)
+              { return a.first > b.first; });
+
+    std::size_t used = 0;
+    for (const auto &entry : ranked)
+    {
+        const ReplicatedEntity &e = entities[entry.second];
+        if (used + e.sizeBytes > client.budgetBytes)
+            continue; // A smaller entity may still fit
+        used += e.sizeBytes;
+        client.selected.push_back(entry.second);
+        client.accumulators[e.id].value = 0;
+    }
+
+    // Forget entities that left the view so the map only tracks what is visible
+    for (auto acc = client.accumulators.begin(); acc != client.accumulators.end();)
+    {
+        if (acc->second.lastSeenTick != tick)
+            acc = client.accumulators.erase(acc);
+        else
+            ++acc;
+    }
+
+    return client.selected;
+}
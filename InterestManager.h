@@ -0,0 +1,70 @@
+#pragma once
+
+#include "SpatialGrid.h"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// An entity the server could replicate this tick
+struct ReplicatedEntity
+{
+    std::uint32_t id;
+    sf::Vector2<float> position;
+    float priority;         // Base importance, e.g. players > projectiles
+    std::uint16_t sizeBytes; // Encoded size of one update for this entity
+    std::uint8_t kind;       // Caller's tag (e.g. EntityKind), not used here
+};
+
+// Area-of-interest filtering for per-client replication.
+// Entities are bucketed in a SpatialGrid once per tick; each client then only
+// touches the cells under its view circle, so relevance cost depends on what
+// the client can see rather than on the size of the map. Within the view,
+// every entity accumulates priority each tick (scaled down with distance) and
+// the highest accumulators are sent until the client's byte budget runs out.
+// Sent entities reset to zero, so far or unimportant entities still update,
+// just less often.
+class InterestManager
+{
+private:
+    struct Accumulator
+    {
+        float value;
+        std::uint64_t lastSeenTick;
+    };
+
+    struct Client
+    {
+        sf::Vector2<float> viewCenter;
+        float viewRadius;
+        std::size_t budgetBytes;
+        std::unordered_map<std::uint32_t, Accumulator> accumulators;
+        std::vector<std::uint32_t> selected;
+    };
+
+    SpatialGrid grid;
+    std::vector<ReplicatedEntity> entities;
+    std::unordered_map<std::uint32_t, Client> clients;
+    std::uint32_t nextClientId;
+    std::uint64_t tick;
+
+    // Scratch buffers reused between clients
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::pair<float, std::uint32_t>> ranked;
+
+public:
+    explicit InterestManager(float cellSize = 256.0f);
+
+    std::uint32_t addClient(float viewRadius, std::size_t budgetBytesPerTick);
+    void removeClient(std::uint32_t clientId);
+    void setClientView(std::uint32_t clientId, const sf::Vector2<float> &center);
+
+    // Call once per server tick with every replicable entity
+    void beginTick(const std::vector<ReplicatedEntity> &worldEntities);
+
+    // Returns what to send to this client this tick, as indices into the
+    // entities given to beginTick(). The reference stays valid until the
+    // next call for the same client.
+    const std::vector<std::uint32_t> &selectForClient(std::uint32_t clientId);
+};
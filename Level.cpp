@@ -0,0 +1,373 @@
+#include "Level.h"
+#include "LevelCompiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+// Resolves a section to a typed pointer, checking bounds and alignment so
+// that a corrupt file is rejected instead of read out of range
+template <typename T>
+bool sectionArray(const std::uint8_t *data, std::size_t size, const LevelSection &section,
+                  const T *&out, std::uint32_t &count)
+{
+    if (section.offset % alignof(T) != 0 || section.offset > size ||
+        section.count > (size - section.offset) / sizeof(T) || section.count > UINT32_MAX)
+        return false;
+
+    out = reinterpret_cast<const T *>(data + section.offset);
+    count = static_cast<std::uint32_t>(section.count);
+    return true;
+}
+
+bool chunkBefore(const LevelChunk &a, const LevelChunk &b) { return a.y != b.y ? a.y < b.y : a.x < b.x; }
+
+std::int32_t chunkOf(float v) { return static_cast<std::int32_t>(std::floor(v / LevelFormat::ChunkSize)); }
+
+struct ChunkKey
+{
+    std::int32_t x, y;
+    bool operator<(const ChunkKey &other) const { return y != other.y ? y < other.y : x < other.x; }
+    bool operator==(const ChunkKey &other) const { return x == other.x && y == other.y; }
+};
+
+template <typename T, typename KeyOf>
+void sortByChunk(std::vector<T> &records, KeyOf keyOf)
+{
+    std::stable_sort(records.begin(), records.end(), [&](const T &a, const T &b)
+                     { return keyOf(a) < keyOf(b); });
+}
+
+// Splits walls at chunk borders, orders every array by chunk and emits the
+// table of per-chunk ranges
+void sortIntoChunks(std::vector<LevelRect> &walls, std::vector<LevelDestructible> &destructibles,
+                    std::vector<LevelSpawn> &spawns, std::vector<LevelChunk> &chunks)
+{
+    const float size = LevelFormat::ChunkSize;
+    std::vector<LevelRect> pieces;
+    for (const LevelRect &wall : walls)
+    {
+        for (std::int32_t cy = chunkOf(wall.y); cy <= chunkOf(wall.y + wall.h); ++cy)
+        {
+            for (std::int32_t cx = chunkOf(wall.x); cx <= chunkOf(wall.x + wall.w); ++cx)
+            {
+                float x0 = std::max(wall.x, cx * size), x1 = std::min(wall.x + wall.w, (cx + 1) * size);
+                float y0 = std::max(wall.y, cy * size), y1 = std::min(wall.y + wall.h, (cy + 1) * size);
+                if (x1 > x0 && y1 > y0)
+                    pieces.push_back({x0, y0, x1 - x0, y1 - y0});
+            }
+        }
+    }
+    walls.swap(pieces);
+
+    auto wallKey = [](const LevelRect &r)
+    { return ChunkKey{chunkOf(r.x), chunkOf(r.y)}; };
+    auto destKey = [](const LevelDestructible &d)
+    { return ChunkKey{chunkOf(d.x + d.w * 0.5f), chunkOf(d.y + d.h * 0.5f)}; };
+    auto spawnKey = [](const LevelSpawn &s)
+    { return ChunkKey{chunkOf(s.x), chunkOf(s.y)}; };
+    sortByChunk(walls, wallKey);
+    sortByChunk(destructibles, destKey);
+    sortByChunk(spawns, spawnKey);
+
+    // Merge the three sorted arrays into one ascending list of chunks
+    std::size_t w = 0, d = 0, s = 0;
+    while (w < walls.size() || d < destructibles.size() || s < spawns.size())
+    {
+        ChunkKey key{INT32_MAX, INT32_MAX};
+        if (w < walls.size())
+            key = std::min(key, wallKey(walls[w]));
+        if (d < destructibles.size())
+            key = std::min(key, destKey(destructibles[d]));
+        if (s < spawns.size())
+            key = std::min(key, spawnKey(spawns[s]));
+
+        LevelChunk chunk{};
+        chunk.x = key.x;
+        chunk.y = key.y;
+        chunk.wallFirst = static_cast<std::uint32_t>(w);
+        while (w < walls.size() && wallKey(walls[w]) == key)
+            ++w;
+        chunk.wallCount = static_cast<std::uint32_t>(w) - chunk.wallFirst;
+        chunk.destructibleFirst = static_cast<std::uint32_t>(d);
+        while (d < destructibles.size() && destKey(destructibles[d]) == key)
+            ++d;
+        chunk.destructibleCount = static_cast<std::uint32_t>(d) - chunk.destructibleFirst;
+        chunk.spawnFirst = static_cast<std::uint32_t>(s);
+        while (s < spawns.size() && spawnKey(spawns[s]) == key)
+            ++s;
+        chunk.spawnCount = static_cast<std::uint32_t>(s) - chunk.spawnFirst;
+        chunks.push_back(chunk);
+    }
+}
+
+std::uint64_t alignUp(std::uint64_t v) { return (v + LevelFormat::SectionAlignment - 1) & ~std::uint64_t(LevelFormat::SectionAlignment - 1); }
+} // namespace
+
+// ============= Level Implementation =============
+
+Level::Level()
+    : sourceHash(0), walls(nullptr), wallCount(0), destructibles(nullptr), destructibleCount(0),
+      spawns(nullptr), spawnCount(0), chunks(nullptr), chunkCount(0) {}
+
+bool Level::bind(const std::uint8_t *data, std::size_t size)
+{
+    if (size < sizeof(LevelHeader))
+        return false;
+
+    const auto *header = reinterpret_cast<const LevelHeader *>(data);
+    if (std::memcmp(header->magic, LevelFormat::Magic, sizeof(header->magic)) != 0 ||
+        header->byteOrder != LevelFormat::ByteOrderMark)
+        return false;
+    if (header->version != LevelFormat::Version)
+    {
+        std::cerr << source << ": level version " << header->version << ", expected "
+                  << LevelFormat::Version << "\n";
+        return false;
+    }
+    if (header->sectionCount > (size - sizeof(LevelHeader)) / sizeof(LevelSection))
+        return false;
+    sourceHash = header->sourceHash;
+
+    const BvhNode *nodes = nullptr;
+    const std::uint32_t *items = nullptr;
+    std::uint32_t nodeCount = 0, itemCount = 0;
+
+    const auto *sections = reinterpret_cast<const LevelSection *>(data + sizeof(LevelHeader));
+    for (std::uint32_t i = 0; i < header->sectionCount; ++i)
+    {
+        const LevelSection &section = sections[i];
+        bool ok = true;
+        switch (static_cast<LevelFormat::SectionType>(section.type))
+        {
+        case LevelFormat::SectionType::Walls:
+            ok = sectionArray(data, size, section, walls, wallCount);
+            break;
+        case LevelFormat::SectionType::Destructibles:
+            ok = sectionArray(data, size, section, destructibles, destructibleCount);
+            break;
+        case LevelFormat::SectionType::Spawns:
+            ok = sectionArray(data, size, section, spawns, spawnCount);
+            break;
+        case LevelFormat::SectionType::WallBvhNodes:
+            ok = sectionArray(data, size, section, nodes, nodeCount);
+            break;
+        case LevelFormat::SectionType::WallBvhItems:
+            ok = sectionArray(data, size, section, items, itemCount);
+            break;
+        case LevelFormat::SectionType::Chunks:
+            ok = sectionArray(data, size, section, chunks, chunkCount);
+            break;
+        default:
+            break; // Unknown sections are skipped so newer writers stay loadable
+        }
+        if (!ok)
+            return false;
+    }
+
+    // The BVH must reference only walls that exist, and children must come
+    // after their parent (as the writer emits them), so a query always ends.
+    // Because they do, depths can be found in the same forward pass; a
+    // query's stack is only sized for StaticBvh::MaxDepth.
+    if (itemCount != wallCount)
+        return false;
+    for (std::uint32_t i = 0; i < itemCount; ++i)
+        if (items[i] >= wallCount)
+            return false;
+    std::vector<std::uint8_t> depth(nodeCount, 0);
+    for (std::uint32_t i = 0; i < nodeCount; ++i)
+    {
+        const BvhNode &node = nodes[i];
+        bool valid = node.count > 0 ? node.first <= itemCount && node.count <= itemCount - node.first
+                                    : node.first > i && node.first < nodeCount - 1 && depth[i] < StaticBvh::MaxDepth;
+        if (!valid)
+            return false;
+        if (node.count == 0)
+        {
+            auto childDepth = static_cast<std::uint8_t>(depth[i] + 1);
+            depth[node.first] = std::max(depth[node.first], childDepth);
+            depth[node.first + 1] = std::max(depth[node.first + 1], childDepth);
+        }
+    }
+
+    // Chunk ranges must stay inside their arrays, keys strictly ascending
+    for (std::uint32_t i = 0; i < chunkCount; ++i)
+    {
+        const LevelChunk &chunk = chunks[i];
+        if (chunk.wallFirst > wallCount || chunk.wallCount > wallCount - chunk.wallFirst ||
+            chunk.destructibleFirst > destructibleCount || chunk.destructibleCount > destructibleCount - chunk.destructibleFirst ||
+            chunk.spawnFirst > spawnCount || chunk.spawnCount > spawnCount - chunk.spawnFirst)
+            return false;
+        if (i > 0 && !chunkBefore(chunks[i - 1], chunk))
+            return false;
+    }
+
+    wallBvh = StaticBvh(nodes, nodeCount, items, itemCount);
+    return true;
+}
+
+sf::Rect<float> Level::getBounds() const
+{
+    if (wallBvh.isEmpty())
+        return {};
+    const BvhNode &root = wallBvh.getNodes()[0];
+    return {{root.minX, root.minY}, {root.maxX - root.minX, root.maxY - root.minY}};
+}
+
+const LevelChunk *Level::findChunk(std::int32_t x, std::int32_t y) const
+{
+    LevelChunk key{};
+    key.x = x;
+    key.y = y;
+    const LevelChunk *end = chunks + chunkCount;
+    const LevelChunk *it = std::lower_bound(chunks, end, key, chunkBefore);
+    return (it != end && it->x == x && it->y == y) ? it : nullptr;
+}
+
+bool Level::loadFromFile(const std::string &path)
+{
+    source = path;
+    if (!mapping.open(path))
+    {
+        std::cerr << "Cannot open level " << path << "\n";
+        return false;
+    }
+    if (!bind(mapping.getData(), mapping.getSize()))
+    {
+        std::cerr << path << " is not a valid level file\n";
+        mapping.close();
+        return false;
+    }
+    return true;
+}
+
+bool Level::loadFromMemory(std::vector<std::uint8_t> data, const std::string &name)
+{
+    source = name;
+    ownedData = std::move(data);
+    return bind(ownedData.data(), ownedData.size());
+}
+
+std::shared_ptr<const Level> Level::builtin()
+{
+    LevelWriter writer;
+    writer.addSpawn(LevelFormat::SpawnKind::Player, 400, 300);
+
+    writer.addWall(0, 0, 800, 20);
+    writer.addWall(0, 580, 800, 20);
+    writer.addWall(0, 0, 20, 600);
+    writer.addWall(780, 0, 20, 600);
+    writer.addWall(200, 200, 100, 20);
+    writer.addWall(500, 400, 20, 150);
+
+    writer.addDestructible(300, 300, 40, 40, 100);
+    writer.addDestructible(600, 200, 40, 40, 100);
+
+    writer.addSpawn(LevelFormat::SpawnKind::Enemy, 200, 100);
+    writer.addSpawn(LevelFormat::SpawnKind::Enemy, 600, 500);
+
+    auto level = std::make_shared<Level>();
+    level->loadFromMemory(writer.build(), "<builtin>");
+    return level;
+}
+
+// ============= LevelWriter Implementation =============
+
+std::vector<std::uint8_t> LevelWriter::build() const
+{
+    std::vector<LevelRect> walls = this->walls;
+    std::vector<LevelDestructible> destructibles = this->destructibles;
+    std::vector<LevelSpawn> spawns = this->spawns;
+    std::vector<LevelChunk> chunks;
+    if (chunked)
+        sortIntoChunks(walls, destructibles, spawns, chunks);
+
+    std::vector<BvhNode> nodes;
+    std::vector<std::uint32_t> items;
+    StaticBvh::build(walls, nodes, items);
+
+    struct Payload
+    {
+        LevelFormat::SectionType type;
+        const void *data;
+        std::size_t recordSize;
+        std::size_t count;
+    };
+    const Payload payloads[] = {
+        {LevelFormat::SectionType::Walls, walls.data(), sizeof(LevelRect), walls.size()},
+        {LevelFormat::SectionType::Destructibles, destructibles.data(), sizeof(LevelDestructible), destructibles.size()},
+        {LevelFormat::SectionType::Spawns, spawns.data(), sizeof(LevelSpawn), spawns.size()},
+        {LevelFormat::SectionType::WallBvhNodes, nodes.data(), sizeof(BvhNode), nodes.size()},
+        {LevelFormat::SectionType::WallBvhItems, items.data(), sizeof(std::uint32_t), items.size()},
+        {LevelFormat::SectionType::Chunks, chunks.data(), sizeof(LevelChunk), chunks.size()},
+    };
+    constexpr std::uint32_t sectionCount = sizeof(payloads) / sizeof(payloads[0]);
+
+    LevelHeader header;
+    std::memcpy(header.magic, LevelFormat::Magic, sizeof(header.magic));
+    header.version = LevelFormat::Version;
+    header.byteOrder = LevelFormat::ByteOrderMark;
+    header.sectionCount = sectionCount;
+    header.sourceHash = sourceHash;
+
+    LevelSection sections[sectionCount];
+    std::uint64_t offset = alignUp(sizeof(LevelHeader) + sizeof(sections));
+    for (std::uint32_t i = 0; i < sectionCount; ++i)
+    {
+        sections[i] = {static_cast<std::uint32_t>(payloads[i].type), 0, offset, payloads[i].count};
+        offset = alignUp(offset + payloads[i].recordSize * payloads[i].count);
+    }
+
+    std::vector<std::uint8_t> out(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), sections, sizeof(sections));
+    for (std::uint32_t i = 0; i < sectionCount; ++i)
+    {
+        if (payloads[i].count > 0)
+            std::memcpy(out.data() + sections[i].offset, payloads[i].data, payloads[i].recordSize * payloads[i].count);
+    }
+    return out;
+}
+
+bool LevelWriter::writeFile(const std::string &path) const
+{
+    std::vector<std::uint8_t> data = build();
+
+    // Write then rename, so a reader never maps a half-written level
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            std::cerr << "Cannot write level " << path << "\n";
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+    {
+        std::cerr << "Cannot write level " << path << ": " << error.message() << "\n";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const Level> loadLevelOrBuiltin(const std::string &path)
+{
+    if (path.empty())
+        return Level::builtin();
+    if (isLevelSource(path))
+        return loadLevelSourceCached(path);
+
+    auto level = std::make_shared<Level>();
+    if (!level->loadFromFile(path))
+        return nullptr;
+    return level;
+}
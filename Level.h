@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "LevelFormat.h"
+#include "MappedFile.h"
+#include "StaticBvh.h"
+
+// A loaded level. The record arrays point straight into the mapped file (or
+// into an owned buffer for levels built in memory) and are never copied.
+class Level
+{
+private:
+    MappedFile mapping;
+    std::vector<std::uint8_t> ownedData;
+    std::string source;
+    std::uint64_t sourceHash;
+
+    const LevelRect *walls;
+    std::uint32_t wallCount;
+    const LevelDestructible *destructibles;
+    std::uint32_t destructibleCount;
+    const LevelSpawn *spawns;
+    std::uint32_t spawnCount;
+    const LevelChunk *chunks;
+    std::uint32_t chunkCount;
+    StaticBvh wallBvh;
+
+    bool bind(const std::uint8_t *data, std::size_t size);
+
+public:
+    Level();
+
+    bool loadFromFile(const std::string &path);
+    bool loadFromMemory(std::vector<std::uint8_t> data, const std::string &name);
+
+    // The arena the game shipped with, built in memory
+    static std::shared_ptr<const Level> builtin();
+
+    const std::string &getSource() const { return source; }
+    std::uint64_t getSourceHash() const { return sourceHash; }
+    const LevelRect *getWalls() const { return walls; }
+    std::uint32_t getWallCount() const { return wallCount; }
+    const LevelDestructible *getDestructibles() const { return destructibles; }
+    std::uint32_t getDestructibleCount() const { return destructibleCount; }
+    const LevelSpawn *getSpawns() const { return spawns; }
+    std::uint32_t getSpawnCount() const { return spawnCount; }
+    const StaticBvh &getWallBvh() const { return wallBvh; }
+
+    // Extent of all walls (the BVH root); empty when there are none
+    sf::Rect<float> getBounds() const;
+
+    // Chunked levels only; nullptr when the chunk is empty or absent
+    bool isChunked() const { return chunkCount > 0; }
+    const LevelChunk *findChunk(std::int32_t x, std::int32_t y) const;
+};
+
+// Builds the binary form of a level, including the precomputed wall BVH
+class LevelWriter
+{
+private:
+    std::vector<LevelRect> walls;
+    std::vector<LevelDestructible> destructibles;
+    std::vector<LevelSpawn> spawns;
+    std::uint64_t sourceHash = 0;
+    bool chunked = false;
+
+public:
+    void addWall(float x, float y, float w, float h) { walls.push_back({x, y, w, h}); }
+    void addDestructible(float x, float y, float w, float h, float hp) { destructibles.push_back({x, y, w, h, hp}); }
+    void addSpawn(LevelFormat::SpawnKind kind, float x, float y)
+    {
+        spawns.push_back({static_cast<std::uint32_t>(kind), x, y});
+    }
+
+    void setSourceHash(std::uint64_t hash) { sourceHash = hash; }
+    // Groups everything into LevelFormat::ChunkSize squares for streaming
+    void setChunked(bool enabled) { chunked = enabled; }
+
+    std::vector<std::uint8_t> build() const;
+    bool writeFile(const std::string &path) const;
+};
+
+// Loads 'path' when given, otherwise returns the builtin level. Text sources
+// (*.txt) go through the compiled-level cache, see LevelCompiler.h.
+std::shared_ptr<const Level> loadLevelOrBuiltin(const std::string &path);
@@ -0,0 +1,178 @@
+#include "LevelCompiler.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+bool readHeader(const std::string &path, LevelHeader &header)
+{
+    std::ifstream file(path, std::ios::binary);
+    return file && file.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+           std::memcmp(header.magic, LevelFormat::Magic, sizeof(header.magic)) == 0 &&
+           header.byteOrder == LevelFormat::ByteOrderMark;
+}
+} // namespace
+
+bool compileLevelSource(const char *text, std::size_t size, LevelWriter &writer, std::string &error)
+{
+    std::istringstream in(std::string(text, size));
+    std::string line;
+    int lineNumber = 0;
+    int players = 0;
+
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword))
+            continue; // Blank or comment-only line
+
+        float x, y, w, h, hp;
+        bool ok = true;
+        if (keyword == "wall")
+        {
+            ok = static_cast<bool>(fields >> x >> y >> w >> h) && w > 0 && h > 0;
+            if (ok)
+                writer.addWall(x, y, w, h);
+        }
+        else if (keyword == "destructible")
+        {
+            ok = static_cast<bool>(fields >> x >> y >> w >> h >> hp) && w > 0 && h > 0 && hp > 0;
+            if (ok)
+                writer.addDestructible(x, y, w, h, hp);
+        }
+        else if (keyword == "enemy")
+        {
+            ok = static_cast<bool>(fields >> x >> y);
+            if (ok)
+                writer.addSpawn(LevelFormat::SpawnKind::Enemy, x, y);
+        }
+        else if (keyword == "chunked")
+        {
+            writer.setChunked(true); // Large arenas: stream in LevelFormat::ChunkSize squares
+        }
+        else if (keyword == "player")
+        {
+            ok = static_cast<bool>(fields >> x >> y) && ++players == 1;
+            if (ok)
+                writer.addSpawn(LevelFormat::SpawnKind::Player, x, y);
+        }
+        else
+        {
+            error = "line " + std::to_string(lineNumber) + ": unknown object '" + keyword + "'";
+            return false;
+        }
+
+        std::string extra;
+        if (!ok || fields >> extra)
+        {
+            error = "line " + std::to_string(lineNumber) + ": bad '" + keyword + "' entry";
+            return false;
+        }
+    }
+
+    if (players == 0)
+    {
+        error = "no player spawn";
+        return false;
+    }
+    return true;
+}
+
+bool compileLevelFile(const std::string &sourcePath, const std::string &outputPath)
+{
+    MappedFile source;
+    if (!source.open(sourcePath))
+    {
+        std::cerr << "Cannot read level source " << sourcePath << "\n";
+        return false;
+    }
+
+    const char *text = reinterpret_cast<const char *>(source.getData());
+    LevelWriter writer;
+    std::string error;
+    if (!compileLevelSource(text, source.getSize(), writer, error))
+    {
+        std::cerr << sourcePath << ": " << error << "\n";
+        return false;
+    }
+
+    writer.setSourceHash(contentHash(source.getData(), source.getSize()));
+    return writer.writeFile(outputPath);
+}
+
+bool isLevelSource(const std::string &path)
+{
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".txt") == 0;
+}
+
+std::string levelCachePath(const std::string &sourcePath, std::uint64_t sourceHash)
+{
+    std::ostringstream name;
+    name << sourcePath << '.' << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".cache.lvl";
+    return name.str();
+}
+
+std::string refreshLevelCache(const std::string &sourcePath)
+{
+    MappedFile source;
+    if (!source.open(sourcePath))
+    {
+        std::cerr << "Cannot read level source " << sourcePath << "\n";
+        return {};
+    }
+    std::uint64_t hash = contentHash(source.getData(), source.getSize());
+    source.close();
+
+    std::string cachePath = levelCachePath(sourcePath, hash);
+    LevelHeader header;
+    if (readHeader(cachePath, header) && header.version == LevelFormat::Version && header.sourceHash == hash)
+        return cachePath;
+
+    std::cout << "Compiling " << sourcePath << " -> " << cachePath << "\n";
+    if (!compileLevelFile(sourcePath, cachePath))
+        return {};
+
+    // Caches of earlier versions of the source. One still mapped (the level
+    // being replaced by a hot reload) cannot be deleted on Windows; it goes
+    // after a later compile instead.
+    const std::string suffix = ".cache.lvl";
+    std::filesystem::path file(sourcePath);
+    std::string prefix = file.filename().string() + ".";
+    std::string current = std::filesystem::path(cachePath).filename().string();
+    std::error_code error;
+    for (const auto &item : std::filesystem::directory_iterator(file.has_parent_path() ? file.parent_path() : ".", error))
+    {
+        std::string name = item.path().filename().string();
+        if (name != current && name.size() == prefix.size() + 16 + suffix.size() && // 16 hex digits of hash
+            name.compare(0, prefix.size(), prefix) == 0 &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            std::error_code ignored;
+            std::filesystem::remove(item.path(), ignored);
+        }
+    }
+    return cachePath;
+}
+
+std::shared_ptr<const Level> loadLevelSourceCached(const std::string &sourcePath)
+{
+    std::string cachePath = refreshLevelCache(sourcePath);
+    if (cachePath.empty())
+        return nullptr;
+
+    auto level = std::make_shared<Level>();
+    if (!level->loadFromFile(cachePath))
+        return nullptr;
+    return level;
+}
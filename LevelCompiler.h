@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ContentHash.h"
+#include "Level.h"
+
+// Human-editable level source, one object per line:
+//
+//   # comment
+//   player x y
+//   enemy x y
+//   wall x y w h
+//   destructible x y w h hp
+//   chunked               (split into streaming chunks, for large arenas)
+//
+// Sources are compiled to the binary format (Level.h). The compiled file
+// records a hash of the source text, so loaders can reuse it until the
+// source changes.
+
+// Parses 'text' into 'writer'. On failure 'error' names the offending line.
+bool compileLevelSource(const char *text, std::size_t size, LevelWriter &writer, std::string &error);
+
+// Source file -> binary level file, stamping the source hash
+bool compileLevelFile(const std::string &sourcePath, const std::string &outputPath);
+
+bool isLevelSource(const std::string &path);
+
+// Where the compiled artifact of one version of a source lives:
+// "<source>.<hash>.cache.lvl". Each edit compiles to a new file, so a
+// recompile never replaces a file that is still mapped (Windows refuses to).
+std::string levelCachePath(const std::string &sourcePath, std::uint64_t sourceHash);
+
+// Compiles the source unless its cache is fresh and deletes the caches of
+// older versions. Returns the cache path, empty on failure.
+std::string refreshLevelCache(const std::string &sourcePath);
+
+// Maps the cached binary, refreshing it first when the source changed
+std::shared_ptr<const Level> loadLevelSourceCached(const std::string &sourcePath);
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// On-disk level layout. Every record is plain old data so a section can be
+// used in place straight out of a memory mapping: no parsing, no copies.
+//
+//   LevelHeader
+//   LevelSection[sectionCount]
+//   section payloads, each starting on a SectionAlignment boundary
+//
+// Files are written in the host's byte order; 'byteOrder' lets a loader
+// reject a file from a machine with the other endianness.
+namespace LevelFormat
+{
+constexpr char Magic[4] = {'S', 'L', 'V', 'L'};
+constexpr std::uint32_t Version = 2; // 2: header carries the source hash
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+constexpr std::uint32_t SectionAlignment = 16;
+constexpr float ChunkSize = 1024.0f; // World units per side of a streaming chunk
+
+enum class SectionType : std::uint32_t
+{
+    Walls = 1,         // LevelRect[]
+    Destructibles = 2, // LevelDestructible[]
+    Spawns = 3,        // LevelSpawn[]
+    WallBvhNodes = 4,  // BvhNode[], node 0 is the root
+    WallBvhItems = 5,  // std::uint32_t[] wall indices referenced by leaves
+    Chunks = 6         // LevelChunk[] sorted by (y, x); only in chunked levels
+};
+
+enum class SpawnKind : std::uint32_t
+{
+    Player = 0,
+    Enemy = 1
+};
+} // namespace LevelFormat
+
+struct LevelHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t sectionCount;
+    std::uint64_t sourceHash; // Hash of the text it was compiled from, 0 if none
+};
+
+struct LevelSection
+{
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset; // From the start of the file
+    std::uint64_t count;  // Number of records
+};
+
+struct LevelRect
+{
+    float x, y, w, h;
+};
+
+struct LevelDestructible
+{
+    float x, y, w, h;
+    float health;
+};
+
+struct LevelSpawn
+{
+    std::uint32_t kind; // LevelFormat::SpawnKind
+    float x, y;
+};
+
+// One ChunkSize square of a chunked level. Walls, destructibles and spawns
+// are sorted by chunk, so each chunk owns contiguous ranges of them; walls
+// crossing a chunk border are split at compile time.
+struct LevelChunk
+{
+    std::int32_t x, y; // Chunk coordinates: floor(position / ChunkSize)
+    std::uint32_t wallFirst, wallCount;
+    std::uint32_t destructibleFirst, destructibleCount;
+    std::uint32_t spawnFirst, spawnCount;
+};
+
+// Flattened AABB tree node. Leaves have count > 0 and cover items
+// [first, first + count); inner nodes have count == 0 and children at
+// 'first' and 'first + 1'.
+struct BvhNode
+{
+    float minX, minY, maxX, maxY;
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+static_assert(std::is_trivially_copyable_v<LevelRect> && sizeof(LevelRect) == 16);
+static_assert(std::is_trivially_copyable_v<LevelDestructible> && sizeof(LevelDestructible) == 20);
+static_assert(std::is_trivially_copyable_v<LevelSpawn> && sizeof(LevelSpawn) == 12);
+static_assert(std::is_trivially_copyable_v<BvhNode> && sizeof(BvhNode) == 24);
+static_assert(std::is_trivially_copyable_v<LevelChunk> && sizeof(LevelChunk) == 32);
+static_assert(sizeof(LevelHeader) == 24 && sizeof(LevelSection) == 24);
@@ -0,0 +1,162 @@
+#include "Lockstep.h"
+#include "NetProtocol.h"
+#include <algorithm>
+#include <iostream>
+
+// ============= LockstepSession Implementation =============
+
+LockstepSession::LockstepSession(std::unique_ptr<Transport> link, int peerIndex)
+    : transport(std::move(link)), localPeer(peerIndex), remotePort(0),
+      nextLocalTick(0), nextSimTick(0), remoteAcked(0), remoteReceived(0)
+{
+    // The first InputDelay ticks have no real input on either side
+    for (std::uint32_t t = 0; t < InputDelay; ++t)
+    {
+        localInputs[t % Window] = {t, PlayerInput()};
+        remoteInputs[t % Window] = {t, PlayerInput()};
+    }
+    nextLocalTick = InputDelay;
+    remoteReceived = InputDelay;
+    remoteAcked = InputDelay;
+}
+
+void LockstepSession::setRemote(const sf::IpAddress &address, unsigned short port)
+{
+    remoteAddress = address;
+    remotePort = port;
+}
+
+bool LockstepSession::hasInput(const std::array<InputSlot, Window> &ring, std::uint32_t tick) const
+{
+    return ring[tick % Window].tick == tick;
+}
+
+bool LockstepSession::pushLocalInput(const PlayerInput &input)
+{
+    if (nextLocalTick >= nextSimTick + InputDelay + 1)
+        return false;
+
+    localInputs[nextLocalTick % Window] = {nextLocalTick, input};
+    ++nextLocalTick;
+    return true;
+}
+
+void LockstepSession::poll()
+{
+    receive();
+    sendInputs();
+}
+
+void LockstepSession::sendInputs()
+{
+    if (!remoteAddress)
+        return;
+
+    // Redundantly resend every unacknowledged input so loss only costs latency
+    std::uint32_t first = remoteAcked;
+    std::uint32_t count = std::min<std::uint32_t>(nextLocalTick - first, 255);
+
+    sf::Packet packet;
+    packet << static_cast<std::uint8_t>(PacketType::Lockstep) << remoteReceived << first
+           << static_cast<std::uint8_t>(count);
+    for (std::uint32_t t = first; t < first + count; ++t)
+    {
+        const PlayerInput &input = localInputs[t % Window].input;
+        packet << packButtons(input) << input.aim.x << input.aim.y;
+    }
+
+    // Latest checksum rides along; the receiver compares when it has its own
+    std::uint32_t checksumTick = nextSimTick > 0 ? nextSimTick - 1 : UINT32_MAX;
+    const ChecksumSlot &sum = localChecksums[checksumTick % Window];
+    if (sum.tick == checksumTick)
+        packet << sum.tick << static_cast<std::uint64_t>(sum.value);
+    else
+        packet << UINT32_MAX << static_cast<std::uint64_t>(0);
+
+    transport->send(packet, *remoteAddress, remotePort);
+}
+
+void LockstepSession::receive()
+{
+    sf::Packet packet;
+    std::optional<sf::IpAddress> sender;
+    unsigned short senderPort = 0;
+
+    while (transport->receive(packet, sender, senderPort))
+    {
+        std::uint8_t type = 0, count = 0;
+        std::uint32_t ack = 0, first = 0;
+        if (!(packet >> type >> ack >> first >> count) || type != static_cast<std::uint8_t>(PacketType::Lockstep))
+            continue;
+
+        if (!remoteAddress && sender)
+            setRemote(*sender, senderPort);
+
+        remoteAcked = std::max(remoteAcked, ack);
+
+        for (std::uint32_t t = first; t < first + count; ++t)
+        {
+            std::uint8_t buttons = 0;
+            PlayerInput input;
+            if (!(packet >> buttons >> input.aim.x >> input.aim.y))
+                break;
+            unpackButtons(buttons, input);
+
+            // Only accept ticks inside the window we can still use
+            if (t >= nextSimTick && t < nextSimTick + Window && !hasInput(remoteInputs, t))
+                remoteInputs[t % Window] = {t, input};
+        }
+        while (hasInput(remoteInputs, remoteReceived))
+            ++remoteReceived;
+
+        std::uint32_t sumTick = 0;
+        std::uint64_t sumValue = 0;
+        if (packet >> sumTick >> sumValue && sumTick != UINT32_MAX)
+        {
+            lastRemoteChecksum = {sumTick, sumValue};
+            compareChecksum(sumTick, sumValue);
+        }
+    }
+}
+
+bool LockstepSession::canAdvance() const
+{
+    return hasInput(localInputs, nextSimTick) && hasInput(remoteInputs, nextSimTick);
+}
+
+PlayerInput LockstepSession::takeTickInput()
+{
+    const PlayerInput &local = localInputs[nextSimTick % Window].input;
+    const PlayerInput &remote = remoteInputs[nextSimTick % Window].input;
+    const PlayerInput &host = localPeer == 0 ? local : remote;
+    const PlayerInput &guest = localPeer == 0 ? remote : local;
+
+    // Same merge on both peers, in peer order rather than local/remote order
+    PlayerInput merged = host;
+    if (!host.shoot && guest.shoot)
+    {
+        merged.shoot = true;
+        merged.aim = guest.aim;
+    }
+
+    ++nextSimTick;
+    return merged;
+}
+
+void LockstepSession::recordChecksum(std::uint32_t tick, std::uint64_t value)
+{
+    localChecksums[tick % Window] = {tick, value};
+    if (lastRemoteChecksum.tick == tick)
+        compareChecksum(tick, lastRemoteChecksum.value);
+}
+
+void LockstepSession::compareChecksum(std::uint32_t tick, std::uint64_t remoteValue)
+{
+    const ChecksumSlot &local = localChecksums[tick % Window];
+    if (local.tick != tick || local.value == remoteValue || desyncTick)
+        return;
+
+    desyncTick = tick;
+    std::cerr << "Lockstep desync at tick " << tick << ": local " << std::hex << local.value
+              << " remote " << remoteValue << std::dec << "\n";
+}
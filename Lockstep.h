@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include "NetTransport.h"
+#include "PlayerInput.h"
+
+// Two-peer deterministic lockstep. Only inputs travel over the wire: each
+// peer schedules its input InputDelay ticks ahead, resends everything the
+// other side has not acknowledged, and a tick is simulated only once both
+// inputs for it are known. Peers also exchange per-tick World checksums so
+// a desync is reported at the first tick where the states diverge.
+//
+// The world has a single player: peer 0 drives movement and either peer can
+// fire (the guest acts as a co-op gunner).
+class LockstepSession
+{
+public:
+    static constexpr std::uint32_t InputDelay = 3;
+
+private:
+    static constexpr std::uint32_t Window = 128; // Ring size, must exceed delay + resend span
+
+    struct InputSlot
+    {
+        std::uint32_t tick = UINT32_MAX;
+        PlayerInput input;
+    };
+
+    struct ChecksumSlot
+    {
+        std::uint32_t tick = UINT32_MAX;
+        std::uint64_t value = 0;
+    };
+
+    std::unique_ptr<Transport> transport;
+    int localPeer;
+    std::optional<sf::IpAddress> remoteAddress;
+    unsigned short remotePort;
+
+    std::array<InputSlot, Window> localInputs;
+    std::array<InputSlot, Window> remoteInputs;
+    std::array<ChecksumSlot, Window> localChecksums;
+
+    std::uint32_t nextLocalTick;  // Next tick a local input will be scheduled for
+    std::uint32_t nextSimTick;    // Next tick to simulate
+    std::uint32_t remoteAcked;    // Remote has every local input below this tick
+    std::uint32_t remoteReceived; // We have every remote input below this tick
+
+    ChecksumSlot lastRemoteChecksum;
+    std::optional<std::uint32_t> desyncTick;
+
+    bool hasInput(const std::array<InputSlot, Window> &ring, std::uint32_t tick) const;
+    void sendInputs();
+    void receive();
+    void compareChecksum(std::uint32_t tick, std::uint64_t remoteValue);
+
+public:
+    LockstepSession(std::unique_ptr<Transport> link, int peerIndex);
+
+    // The joining peer knows the host; the host learns the peer from its first packet
+    void setRemote(const sf::IpAddress &address, unsigned short port);
+
+    // Returns false while the local side is already InputDelay ticks ahead
+    bool pushLocalInput(const PlayerInput &input);
+    void poll();
+
+    bool canAdvance() const;
+    PlayerInput takeTickInput(); // Merged input for the next tick; advances it
+
+    void recordChecksum(std::uint32_t tick, std::uint64_t value);
+
+    std::uint32_t getNextSimTick() const { return nextSimTick; }
+    std::optional<std::uint32_t> getDesyncTick() const { return desyncTick; }
+};
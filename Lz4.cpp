@@ -0,0 +1,154 @@
+#include "Lz4.h"
+#include <cstring>
+
+namespace
+{
+constexpr std::size_t MinMatch = 4;
+constexpr std::size_t LastLiterals = 5;  // Format rule: block ends with >= 5 literals
+constexpr std::size_t MatchSafeEnd = 12; // Format rule: no match starts in the last 12 bytes
+constexpr std::size_t MaxOffset = 65535;
+constexpr int HashBits = 12;
+
+std::uint32_t read32(const std::uint8_t *p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint32_t hashSequence(std::uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+void writeLength(std::size_t length, std::vector<std::uint8_t> &out)
+{
+    while (length >= 255)
+    {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<std::uint8_t>(length));
+}
+
+void emitSequence(const std::uint8_t *literals, std::size_t literalLength,
+                  std::size_t offset, std::size_t matchLength, std::vector<std::uint8_t> &out)
+{
+    std::size_t matchCode = matchLength >= MinMatch ? matchLength - MinMatch : 0;
+    std::uint8_t token = static_cast<std::uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (matchLength >= MinMatch)
+        token |= static_cast<std::uint8_t>(matchCode < 15 ? matchCode : 15);
+    out.push_back(token);
+
+    if (literalLength >= 15)
+        writeLength(literalLength - 15, out);
+    out.insert(out.end(), literals, literals + literalLength);
+
+    if (matchLength < MinMatch)
+        return; // Final literal-only sequence
+
+    out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(offset >> 8));
+    if (matchCode >= 15)
+        writeLength(matchCode - 15, out);
+}
+
+bool readLength(const std::uint8_t *&ip, const std::uint8_t *end, std::size_t &length)
+{
+    std::uint8_t byte;
+    do
+    {
+        if (ip >= end)
+            return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+} // namespace
+
+void lz4Compress(const std::uint8_t *src, std::size_t size, std::vector<std::uint8_t> &out)
+{
+    std::size_t anchor = 0;
+
+    if (size > MatchSafeEnd)
+    {
+        std::vector<std::uint32_t> table(std::size_t(1) << HashBits, UINT32_MAX);
+        std::size_t ip = 0;
+        std::size_t matchStartLimit = size - MatchSafeEnd;
+        std::size_t matchEndLimit = size - LastLiterals;
+
+        while (ip < matchStartLimit)
+        {
+            std::uint32_t sequence = read32(src + ip);
+            std::uint32_t &slot = table[hashSequence(sequence)];
+            std::size_t ref = slot;
+            slot = static_cast<std::uint32_t>(ip);
+
+            if (ref == UINT32_MAX || ip - ref > MaxOffset || read32(src + ref) != sequence)
+            {
+                ++ip;
+                continue;
+            }
+
+            std::size_t length = MinMatch;
+            while (ip + length < matchEndLimit && src[ref + length] == src[ip + length])
+                ++length;
+
+            emitSequence(src + anchor, ip - anchor, ip - ref, length, out);
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    emitSequence(src + anchor, size - anchor, 0, 0, out);
+}
+
+bool lz4Decompress(const std::uint8_t *src, std::size_t srcSize, std::uint8_t *dst, std::size_t dstSize)
+{
+    const std::uint8_t *ip = src;
+    const std::uint8_t *ipEnd = src + srcSize;
+    std::uint8_t *op = dst;
+    std::uint8_t *opEnd = dst + dstSize;
+
+    while (ip < ipEnd)
+    {
+        std::uint8_t token = *ip++;
+
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, ipEnd, literalLength))
+            return false;
+        if (literalLength > static_cast<std::size_t>(ipEnd - ip) ||
+            literalLength > static_cast<std::size_t>(opEnd - op))
+            return false;
+        if (literalLength > 0)
+            std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == ipEnd)
+            break; // Last sequence has no match part
+
+        if (ipEnd - ip < 2)
+            return false;
+        std::size_t offset = static_cast<std::size_t>(ip[0]) | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst))
+            return false;
+
+        std::size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, ipEnd, matchLength))
+            return false;
+        matchLength += MinMatch;
+        if (matchLength > static_cast<std::size_t>(opEnd - op))
+            return false;
+
+        // Byte copy: source and destination may overlap (repeating patterns)
+        const std::uint8_t *match = op - offset;
+        for (std::size_t i = 0; i < matchLength; ++i)
+            op[i] = match[i];
+        op += matchLength;
+    }
+
+    return op == opEnd;
+}
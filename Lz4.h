@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal LZ4 block codec (raw blocks, no frame header), compatible with the
+// reference LZ4_compress_default / LZ4_decompress_safe output. Only used for
+// asset archive entries, so it favors simplicity over peak ratio.
+
+// Appends the compressed form of 'src' to 'out'
+void lz4Compress(const std::uint8_t *src, std::size_t size, std::vector<std::uint8_t> &out);
+
+// Decodes exactly 'dstSize' bytes. Returns false on malformed or truncated
+// input; never reads or writes out of bounds.
+bool lz4Decompress(const std::uint8_t *src, std::size_t srcSize, std::uint8_t *dst, std::size_t dstSize);
+
+// Upper bound on what 'srcSize' compressed bytes can decode to: a length
+// byte adds at most 255 to a match. Larger claimed sizes are corrupt.
+constexpr std::uint64_t lz4MaxDecompressedSize(std::uint64_t srcSize) { return srcSize * 255 + 16; }
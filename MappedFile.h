@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are faulted in on first
+// touch, so opening a large file costs the same as opening a small one.
+class MappedFile
+{
+private:
+    const std::uint8_t *data;
+    std::size_t size;
+#if defined(_WIN32)
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    const std::uint8_t *getData() const { return data; }
+    std::size_t getSize() const { return size; }
+    bool isOpen() const { return data != nullptr; }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SFML/Network/Packet.hpp>
+#include <cstdint>
+#include "PlayerInput.h"
+
+// Every server datagram starts with a type byte and the id of the match it is
+// for. The match id also selects the shard: shard = matchId % shardCount.
+// Lockstep datagrams are peer to peer and carry no match id.
+enum class PacketType : std::uint8_t
+{
+    Join = 1,  // client -> server: attach to a match, echoing the Challenge nonce (0 before it has one)
+    Input = 2, // client -> server: one tick of input for the match's player
+    State = 3,   // server -> client: entities relevant to that client
+    Lockstep = 4, // peer -> peer: unacknowledged inputs plus the latest checksum
+    Challenge = 5 // server -> client: nonce the next Join must echo
+};
+
+// Entity kinds carried in State packets
+enum class EntityKind : std::uint8_t
+{
+    Player = 1,
+    Enemy = 2,
+    Projectile = 3,
+    Destructible = 4
+};
+
+// Bytes one entity takes in a State packet: id, kind, x, y
+constexpr std::uint16_t StateEntityBytes = 4 + 1 + 4 + 4;
+
+inline std::uint8_t packButtons(const PlayerInput &input)
+{
+    return static_cast<std::uint8_t>((input.up ? 1 : 0) | (input.down ? 2 : 0) |
+                                     (input.left ? 4 : 0) | (input.right ? 8 : 0) |
+                                     (input.shoot ? 16 : 0));
+}
+
+inline void unpackButtons(std::uint8_t bits, PlayerInput &input)
+{
+    input.up = bits & 1;
+    input.down = bits & 2;
+    input.left = bits & 4;
+    input.right = bits & 8;
+    input.shoot = bits & 16;
+}
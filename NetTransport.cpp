@@ -0,0 +1,164 @@
+#include "NetTransport.h"
+#include <algorithm>
+
+namespace
+{
+void copyBytes(const sf::Packet &packet, std::vector<std::uint8_t> &bytes)
+{
+    const auto *data = static_cast<const std::uint8_t *>(packet.getData());
+    bytes.assign(data, data + packet.getDataSize());
+}
+
+void fillPacket(sf::Packet &packet, const std::vector<std::uint8_t> &bytes)
+{
+    packet.clear();
+    packet.append(bytes.data(), bytes.size());
+}
+} // namespace
+
+// ============= UdpTransport Implementation =============
+
+bool UdpTransport::bind(unsigned short port)
+{
+    if (socket.bind(port) != sf::Socket::Status::Done)
+        return false;
+    socket.setBlocking(false);
+    return true;
+}
+
+void UdpTransport::send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port)
+{
+    // UDP: failures look the same as loss to the other side
+    (void)socket.send(packet, address, port);
+}
+
+bool UdpTransport::receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                           unsigned short &port)
+{
+    return socket.receive(packet, address, port) == sf::Socket::Status::Done;
+}
+
+// ============= LoopbackNetwork Implementation =============
+
+void LoopbackNetwork::post(unsigned short fromPort, unsigned short toPort, const sf::Packet &packet)
+{
+    Datagram datagram{fromPort, {}};
+    copyBytes(packet, datagram.bytes);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    inboxes[toPort].push_back(std::move(datagram));
+}
+
+bool LoopbackNetwork::take(unsigned short port, sf::Packet &packet, unsigned short &fromPort)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = inboxes.find(port);
+    if (it == inboxes.end() || it->second.empty())
+        return false;
+
+    fillPacket(packet, it->second.front().bytes);
+    fromPort = it->second.front().fromPort;
+    it->second.pop_front();
+    return true;
+}
+
+// ============= LoopbackTransport Implementation =============
+
+LoopbackTransport::LoopbackTransport(LoopbackNetwork &net, unsigned short port)
+    : network(net), localPort(port) {}
+
+void LoopbackTransport::send(sf::Packet &packet, const sf::IpAddress &, unsigned short port)
+{
+    network.post(localPort, port, packet);
+}
+
+bool LoopbackTransport::receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                                unsigned short &port)
+{
+    if (!network.take(localPort, packet, port))
+        return false;
+    address = sf::IpAddress::LocalHost;
+    return true;
+}
+
+// ============= ConditionedTransport Implementation =============
+
+ConditionedTransport::ConditionedTransport(std::unique_ptr<Transport> wrapped, const NetConditions &cond)
+    : inner(std::move(wrapped)), conditions(cond), rng(cond.seed), unit(0.0f, 1.0f),
+      sent(0), dropped(0), duplicated(0) {}
+
+bool ConditionedTransport::laterFirst(const Pending &a, const Pending &b)
+{
+    if (a.deliverAtMs != b.deliverAtMs)
+        return a.deliverAtMs > b.deliverAtMs;
+    return a.order > b.order;
+}
+
+void ConditionedTransport::schedule(const sf::Packet &packet, const sf::IpAddress &address,
+                                    unsigned short port, float nowMs)
+{
+    float delay = conditions.latencyMs + (unit(rng) * 2.0f - 1.0f) * conditions.jitterMs;
+    if (unit(rng) * 100.0f < conditions.reorderPercent)
+        delay += std::max(conditions.latencyMs, 1.0f);
+
+    Pending entry{nowMs + std::max(delay, 0.0f), sent++, address, port, {}};
+    copyBytes(packet, entry.bytes);
+    pending.push_back(std::move(entry));
+    std::push_heap(pending.begin(), pending.end(), laterFirst);
+}
+
+void ConditionedTransport::send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port)
+{
+    float nowMs = clock.getElapsedTime().asSeconds() * 1000.0f;
+
+    // Draw every decision up front so the random stream does not depend on timing
+    bool lose = unit(rng) * 100.0f < conditions.lossPercent;
+    bool duplicate = unit(rng) * 100.0f < conditions.duplicatePercent;
+
+    if (lose)
+    {
+        ++dropped;
+    }
+    else
+    {
+        schedule(packet, address, port, nowMs);
+        if (duplicate)
+        {
+            ++duplicated;
+            schedule(packet, address, port, nowMs);
+        }
+    }
+
+    flushDue();
+}
+
+void ConditionedTransport::flushDue()
+{
+    float nowMs = clock.getElapsedTime().asSeconds() * 1000.0f;
+    sf::Packet packet;
+
+    while (!pending.empty() && pending.front().deliverAtMs <= nowMs)
+    {
+        std::pop_heap(pending.begin(), pending.end(), laterFirst);
+        Pending &due = pending.back();
+        fillPacket(packet, due.bytes);
+        inner->send(packet, due.address, due.port);
+        pending.pop_back();
+    }
+}
+
+bool ConditionedTransport::receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                                   unsigned short &port)
+{
+    // Receiving is the natural polling point for releasing delayed sends
+    flushDue();
+    return inner->receive(packet, address, port);
+}
+
+std::unique_ptr<Transport> applyConditions(std::unique_ptr<Transport> transport,
+                                           const NetConditions &conditions)
+{
+    if (!conditions.isActive())
+        return transport;
+    return std::make_unique<ConditionedTransport>(std::move(transport), conditions);
+}
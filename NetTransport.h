@@ -0,0 +1,138 @@
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Datagram transport used by the server and any networked client, so the
+// real socket can be swapped for a loopback or a degraded link
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    virtual void send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port) = 0;
+
+    // Non-blocking: returns false when nothing is waiting
+    virtual bool receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                         unsigned short &port) = 0;
+};
+
+// Plain non-blocking sf::UdpSocket
+class UdpTransport : public Transport
+{
+private:
+    sf::UdpSocket socket;
+
+public:
+    bool bind(unsigned short port);
+
+    void send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port) override;
+    bool receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                 unsigned short &port) override;
+};
+
+// In-process stand-in for the loopback interface: ports map to inboxes and
+// every datagram appears to come from 127.0.0.1. Safe to share across threads.
+class LoopbackNetwork
+{
+private:
+    struct Datagram
+    {
+        unsigned short fromPort;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<unsigned short, std::deque<Datagram>> inboxes;
+
+public:
+    void post(unsigned short fromPort, unsigned short toPort, const sf::Packet &packet);
+    bool take(unsigned short port, sf::Packet &packet, unsigned short &fromPort);
+};
+
+class LoopbackTransport : public Transport
+{
+private:
+    LoopbackNetwork &network;
+    unsigned short localPort;
+
+public:
+    LoopbackTransport(LoopbackNetwork &net, unsigned short port);
+
+    void send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port) override;
+    bool receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                 unsigned short &port) override;
+};
+
+// Link impairments applied to outgoing datagrams
+struct NetConditions
+{
+    float latencyMs = 0;
+    float jitterMs = 0;       // Uniform +/- around latency
+    float lossPercent = 0;
+    float duplicatePercent = 0;
+    float reorderPercent = 0; // Held back an extra latency so later packets overtake
+    std::uint32_t seed = 1;
+
+    bool isActive() const
+    {
+        return latencyMs > 0 || jitterMs > 0 || lossPercent > 0 ||
+               duplicatePercent > 0 || reorderPercent > 0;
+    }
+};
+
+// Wraps another transport and delays, drops, duplicates or reorders what is
+// sent through it. All random decisions come from one seeded generator, so a
+// given seed and send sequence always produces the same impairments.
+class ConditionedTransport : public Transport
+{
+private:
+    struct Pending
+    {
+        float deliverAtMs;
+        std::uint64_t order; // Tie-break so equal times keep send order
+        sf::IpAddress address;
+        unsigned short port;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    std::unique_ptr<Transport> inner;
+    NetConditions conditions;
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> unit;
+    std::vector<Pending> pending; // Min-heap on deliverAtMs
+    std::uint64_t sent;
+    sf::Clock clock;
+
+    std::uint64_t dropped;
+    std::uint64_t duplicated;
+
+    static bool laterFirst(const Pending &a, const Pending &b);
+    void schedule(const sf::Packet &packet, const sf::IpAddress &address,
+                  unsigned short port, float nowMs);
+    void flushDue();
+
+public:
+    ConditionedTransport(std::unique_ptr<Transport> wrapped, const NetConditions &cond);
+
+    void send(sf::Packet &packet, const sf::IpAddress &address, unsigned short port) override;
+    bool receive(sf::Packet &packet, std::optional<sf::IpAddress> &address,
+                 unsigned short &port) override;
+
+    std::uint64_t getDropped() const { return dropped; }
+    std::uint64_t getDuplicated() const { return duplicated; }
+};
+
+// Wraps 'transport' in a ConditionedTransport when any impairment is set
+std::unique_ptr<Transport> applyConditions(std::unique_ptr<Transport> transport,
+                                           const NetConditions &conditions);
@@ -0,0 +1,163 @@
+#include "Options.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static bool parsePort(const char *begin, const char *end, unsigned short &port)
+{
+    unsigned int number = 0;
+    auto [last, error] = std::from_chars(begin, end, number);
+    if (error != std::errc() || last != end || number == 0 || number > 65535)
+        return false;
+    port = static_cast<unsigned short>(number);
+    return true;
+}
+
+// HOST:PORT, split at the last colon
+static bool parseHostPort(const char *value, std::string &host, unsigned short &port)
+{
+    const char *colon = std::strrchr(value, ':');
+    if (!colon || colon == value || !parsePort(colon + 1, value + std::strlen(value), port))
+        return false;
+    host.assign(value, colon);
+    return true;
+}
+
+static bool parsePacing(const char *name, PacingMode &mode)
+{
+    static const struct
+    {
+        const char *name;
+        PacingMode mode;
+    } Modes[] = {{"vsync", PacingMode::VSync}, {"uncapped", PacingMode::Uncapped},
+                 {"cap", PacingMode::Capped}, {"sleep", PacingMode::Sleep}};
+    for (const auto &entry : Modes)
+    {
+        if (std::strcmp(name, entry.name) == 0)
+        {
+            mode = entry.mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --matches N     Run N headless matches as a load test and report ticks/sec\n"
+              << "  --duration S    Load test length in seconds (default 5)\n"
+              << "  --server N      Run a dedicated server hosting N matches\n"
+              << "  --port P        First UDP port, shard i listens on P + i (default 47000)\n"
+              << "  --shards N      Worker threads for --matches/--server (default: one per core)\n"
+              << "  --soak N        Run a server and N bot clients in-process over loopback\n"
+              << "  --fixed-step    Deterministic fixed-dt simulation (implied by lockstep)\n"
+              << "  --lockstep-host P          Host a two-player lockstep game on UDP port P\n"
+              << "  --lockstep-join HOST:PORT  Join a lockstep host\n"
+              << "  --level FILE    Load a binary level instead of the builtin arena\n"
+              << "  --chunk-cache MB  Memory cap for streamed chunks of chunked levels (default 64)\n"
+              << "  --assets FILE   Load assets from a packed archive (see assetpack)\n"
+              << "  --asset-root D  Directory for assets not in the archive (default assets)\n"
+              << "  --asset-report  Print per-asset decode/upload times once loading settles\n"
+              << "  --startup-report  Print how long each startup step took, up to the first frame\n"
+              << "  --save FILE     Quicksave file for F5/F9 (default quicksave.snp)\n"
+              << "  --rewind S      Keep S seconds of history; hold Backspace to rewind (implies --fixed-step)\n"
+              << "  --capture FILE  Record every frame to FILE as raw RGBA (F12 saves a screenshot any time)\n"
+              << "  --fog           Fog of war: darken what the player has no line of sight to\n"
+              << "  --pacing M      vsync (default), uncapped, cap (sleep then spin, steadiest)\n"
+              << "                  or sleep (cap without spinning: less CPU, more jitter)\n"
+              << "  --fps N         Frame rate for --pacing cap/sleep (default 120)\n"
+              << "  --record FILE   Record every tick's input (implies --fixed-step)\n"
+              << "  --replay FILE   Replay a recorded input log headless and verify it\n"
+              << "  --render-bench N  Run N frames through the render path with a null backend (no GPU)\n"
+              << "Network simulation (applied to every transport the process opens):\n"
+              << "  --latency MS    One-way delay added to each sent datagram\n"
+              << "  --jitter MS     Uniform +/- variation around the latency\n"
+              << "  --loss PCT      Percentage of datagrams dropped\n"
+              << "  --dup PCT       Percentage of datagrams sent twice\n"
+              << "  --reorder PCT   Percentage of datagrams held back to arrive out of order\n"
+              << "  --seed N        Seed for all simulated impairments (default 1)\n";
+}
+
+bool parseOptions(int argc, char **argv, GameOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--matches") == 0 && value)
+            options.loadTestMatches = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--duration") == 0 && value)
+            options.loadTestSeconds = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--server") == 0 && value)
+            options.serverMatches = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--port") == 0 && value && parsePort(value, value + std::strlen(value), options.port))
+            ++i;
+        else if (std::strcmp(arg, "--shards") == 0 && value)
+            options.shards = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--soak") == 0 && value)
+            options.soakClients = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--fixed-step") == 0)
+            options.fixedStep = true;
+        else if (std::strcmp(arg, "--lockstep-host") == 0 && value &&
+                 parsePort(value, value + std::strlen(value), options.lockstepHostPort))
+            ++i;
+        else if (std::strcmp(arg, "--lockstep-join") == 0 && value &&
+                 parseHostPort(value, options.lockstepJoinHost, options.lockstepJoinPort))
+            ++i;
+        else if (std::strcmp(arg, "--level") == 0 && value)
+            options.levelPath = argv[++i];
+        else if (std::strcmp(arg, "--chunk-cache") == 0 && value)
+            options.chunkCacheMb = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--assets") == 0 && value)
+            options.assetArchive = argv[++i];
+        else if (std::strcmp(arg, "--asset-root") == 0 && value)
+            options.assetRoot = argv[++i];
+        else if (std::strcmp(arg, "--asset-report") == 0)
+            options.assetReport = true;
+        else if (std::strcmp(arg, "--startup-report") == 0)
+            options.startupReport = true;
+        else if (std::strcmp(arg, "--save") == 0 && value)
+            options.savePath = argv[++i];
+        else if (std::strcmp(arg, "--rewind") == 0 && value)
+            options.rewindSeconds = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--pacing") == 0 && value && parsePacing(value, options.pacing))
+            ++i;
+        else if (std::strcmp(arg, "--fps") == 0 && value)
+            options.fpsCap = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--fog") == 0)
+            options.fogOfWar = true;
+        else if (std::strcmp(arg, "--capture") == 0 && value)
+            options.capturePath = argv[++i];
+        else if (std::strcmp(arg, "--record") == 0 && value)
+            options.recordPath = argv[++i];
+        else if (std::strcmp(arg, "--replay") == 0 && value)
+            options.replayPath = argv[++i];
+        else if (std::strcmp(arg, "--render-bench") == 0 && value)
+            options.renderBenchFrames = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--latency") == 0 && value)
+            options.net.latencyMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--jitter") == 0 && value)
+            options.net.jitterMs = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--loss") == 0 && value)
+            options.net.lossPercent = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--dup") == 0 && value)
+            options.net.duplicatePercent = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--reorder") == 0 && value)
+            options.net.reorderPercent = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--seed") == 0 && value)
+            options.net.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // Recording and lockstep only make sense on the deterministic path
+    if (options.isLockstep() || !options.recordPath.empty() || options.rewindSeconds > 0)
+        options.fixedStep = true;
+    return true;
+}
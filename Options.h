@@ -0,0 +1,41 @@
+#pragma once
+
+#include "NetTransport.h"
+#include "PacingMode.h"
+#include <string>
+
+// Command-line options shared by the client and the headless modes
+struct GameOptions
+{
+    int loadTestMatches = 0;      // --matches N: headless load test with N matches
+    float loadTestSeconds = 5.0f; // --duration S
+    int serverMatches = 0;        // --server N: dedicated server hosting N matches
+    unsigned short port = 47000;  // --port P: first shard port, shard i uses P + i
+    int shards = 0;               // --shards N: worker threads, 0 = one per core
+    int soakClients = 0;          // --soak N: in-process server plus N bot clients over loopback
+    NetConditions net;            // --latency/--jitter/--loss/--dup/--reorder/--seed
+    bool fixedStep = false;       // --fixed-step: simulate in World::FixedDt steps
+    unsigned short lockstepHostPort = 0; // --lockstep-host P: wait for a peer on port P
+    std::string lockstepJoinHost; // --lockstep-join HOST:PORT: connect to a lockstep host
+    unsigned short lockstepJoinPort = 0;
+    std::string recordPath;       // --record FILE: log every tick's input
+    std::string replayPath;       // --replay FILE: headless replay of a recorded log
+    int renderBenchFrames = 0;    // --render-bench N: record and submit N frames to a null backend
+    std::string levelPath;        // --level FILE: binary level, builtin arena when empty
+    int chunkCacheMb = 64;        // --chunk-cache MB: memory cap for streamed chunks of chunked levels
+    std::string assetArchive;     // --assets FILE: packed asset archive
+    std::string assetRoot = "assets"; // --asset-root DIR: loose files not found in the archive
+    bool assetReport = false;     // --asset-report: print per-asset load times once loaded
+    bool startupReport = false;   // --startup-report: print the startup timeline at the first frame
+    std::string savePath = "quicksave.snp"; // --save FILE: F5 writes a snapshot here, F9 restores it
+    float rewindSeconds = 0;      // --rewind S: keep S seconds of history, hold Backspace to rewind
+    std::string capturePath;      // --capture FILE: record every frame as raw RGBA
+    bool fogOfWar = false;        // --fog: darken what the player has no line of sight to
+    PacingMode pacing = PacingMode::VSync; // --pacing vsync|uncapped|cap|sleep
+    int fpsCap = 120;             // --fps N: rate for the cap and sleep pacing modes
+
+    bool isLockstep() const { return lockstepHostPort != 0 || !lockstepJoinHost.empty(); }
+};
+
+// Returns false (after printing usage) on unknown or malformed arguments
+bool parseOptions(int argc, char **argv, GameOptions &options);
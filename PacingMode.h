@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// How the main loop paces frames (--pacing); FramePacer implements them
+enum class PacingMode : std::uint8_t
+{
+    VSync,    // The driver blocks in display(); lowest power, latency up to a refresh
+    Uncapped, // As fast as possible
+    Capped,   // Fixed rate: sleep, then spin for the last stretch
+    Sleep     // Fixed rate, sleep only: no spinning CPU, more jitter
+};
@@ -0,0 +1,179 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr float Pi = 3.14159265f;
+constexpr float Drag = 3.0f; // Velocity decays by e^-Drag per second
+
+struct Preset
+{
+    std::size_t burst;  // Spawned at once
+    float rate;         // Then per second, for 'duration' seconds
+    float duration;
+    float speedMin, speedMax;
+    float angleOffset;  // Added to the event direction (pi: spray back at the shooter)
+    float spread;       // +/- radians around it
+    float lifeMin, lifeMax;
+    float sizeMin, sizeMax;
+    sf::Color color;
+};
+
+constexpr Preset Presets[] = {
+    {10, 0, 0, 80, 220, 0, 0.35f, 0.05f, 0.12f, 3, 6, sf::Color(255, 230, 140)},          // MuzzleFlash
+    {16, 0, 0, 60, 240, Pi, 1.2f, 0.12f, 0.3f, 2, 3, sf::Color(255, 190, 80)},            // Sparks
+    {30, 120, 0.2f, 30, 180, 0, 0.9f, 0.3f, 0.8f, 3, 6, sf::Color(220, 40, 40)},          // EnemyDebris
+    {40, 160, 0.3f, 40, 200, 0, Pi, 0.4f, 1.0f, 3, 7, sf::Color(139, 69, 19)},            // WoodDebris
+};
+static_assert(sizeof(Presets) / sizeof(Presets[0]) == static_cast<std::size_t>(EffectType::Count));
+} // namespace
+
+// ============= ParticleSystem Implementation =============
+
+ParticleSystem::ParticleSystem()
+    : posX(MaxParticles), posY(MaxParticles), velX(MaxParticles), velY(MaxParticles), age(MaxParticles),
+      ageRate(MaxParticles), size(MaxParticles), color(MaxParticles), count(0), dropped(0), emitters{},
+      emitterCount(0), rngState(0x9E3779B9u) {}
+
+float ParticleSystem::random(float min, float max)
+{
+    // xorshift32; cosmetic only, so it need not match across machines
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return min + (max - min) * static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::spawn(EffectType type, sf::Vector2<float> position, sf::Vector2<float> direction, std::size_t amount)
+{
+    const Preset &preset = Presets[static_cast<std::size_t>(type)];
+    bool aimed = direction.x != 0 || direction.y != 0;
+    float base = aimed ? std::atan2(direction.y, direction.x) + preset.angleOffset : 0;
+    float spread = aimed ? preset.spread : Pi;
+
+    std::size_t room = MaxParticles - count;
+    if (amount > room)
+    {
+        dropped += amount - room;
+        amount = room;
+    }
+
+    for (std::size_t n = 0; n < amount; ++n)
+    {
+        std::size_t i = count++;
+        float angle = base + random(-spread, spread);
+        float speed = random(preset.speedMin, preset.speedMax);
+        posX[i] = position.x;
+        posY[i] = position.y;
+        velX[i] = std::cos(angle) * speed;
+        velY[i] = std::sin(angle) * speed;
+        age[i] = 0;
+        ageRate[i] = 1.0f / random(preset.lifeMin, preset.lifeMax);
+        size[i] = random(preset.sizeMin, preset.sizeMax);
+        color[i] = preset.color.toInteger();
+    }
+}
+
+void ParticleSystem::emit(EffectType type, sf::Vector2<float> position, sf::Vector2<float> direction)
+{
+    const Preset &preset = Presets[static_cast<std::size_t>(type)];
+    spawn(type, position, direction, preset.burst);
+    if (preset.duration <= 0)
+        return;
+
+    if (emitterCount < MaxEmitters)
+        emitters[emitterCount++] = {type, position, direction, preset.duration, 0};
+    else
+        spawn(type, position, direction, static_cast<std::size_t>(preset.rate * preset.duration)); // Pool full: all at once
+}
+
+void ParticleSystem::update(float dt)
+{
+    for (std::size_t e = 0; e < emitterCount;)
+    {
+        Emitter &emitter = emitters[e];
+        float owed = Presets[static_cast<std::size_t>(emitter.type)].rate * std::min(dt, emitter.remaining) + emitter.carry;
+        auto amount = static_cast<std::size_t>(owed);
+        emitter.carry = owed - static_cast<float>(amount);
+        spawn(emitter.type, emitter.position, emitter.direction, amount);
+
+        emitter.remaining -= dt;
+        if (emitter.remaining <= 0)
+            emitter = emitters[--emitterCount];
+        else
+            ++e;
+    }
+
+    // Integrate and age: one branch-free pass over plain float arrays
+    float damping = std::exp(-Drag * dt);
+    float *px = posX.data(), *py = posY.data(), *vx = velX.data(), *vy = velY.data();
+    float *a = age.data();
+    const float *rate = ageRate.data();
+    std::size_t n = count;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        vx[i] *= damping;
+        vy[i] *= damping;
+        a[i] += rate[i] * dt;
+    }
+
+    // Kill: compact the survivors to the front, keeping their order
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (a[i] >= 1.0f)
+            continue;
+        if (live != i)
+        {
+            px[live] = px[i];
+            py[live] = py[i];
+            vx[live] = vx[i];
+            vy[live] = vy[i];
+            a[live] = a[i];
+            ageRate[live] = rate[i];
+            size[live] = size[i];
+            color[live] = color[i];
+        }
+        ++live;
+    }
+    count = live;
+}
+
+void ParticleSystem::draw(sf::RenderTarget &target, const sf::Rect<float> &visible)
+{
+    bool shader = discs.isAvailable();
+    sf::Vector2<float> min = visible.position, max = visible.position + visible.size;
+    quads.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // Fade out and shrink to half size over the lifetime
+        float s = size[i] * (1.0f - 0.5f * age[i]);
+        sf::Vector2<float> p0(posX[i] - s * 0.5f, posY[i] - s * 0.5f), p1(p0.x + s, p0.y + s);
+        if (p1.x < min.x || p1.y < min.y || p0.x > max.x || p0.y > max.y)
+            continue;
+
+        sf::Color tint(color[i]);
+        tint.a = static_cast<std::uint8_t>(static_cast<float>(tint.a) * (1.0f - age[i]));
+        if (shader)
+        {
+            discs.add({p0, {s, s}}, tint);
+            continue;
+        }
+        quads.push_back({p0, tint});
+        quads.push_back({{p1.x, p0.y}, tint});
+        quads.push_back({{p0.x, p1.y}, tint});
+        quads.push_back({{p0.x, p1.y}, tint});
+        quads.push_back({{p1.x, p0.y}, tint});
+        quads.push_back({p1, tint});
+    }
+
+    // Additive: overlapping sparks brighten instead of hiding each other
+    if (shader)
+        discs.draw(target, sf::BlendAdd);
+    else if (!quads.empty())
+        target.draw(quads.data(), quads.size(), sf::PrimitiveType::Triangles, sf::RenderStates(sf::BlendAdd));
+}
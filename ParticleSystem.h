@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ProjectileRenderer.h"
+
+enum class EffectType : std::uint8_t
+{
+    MuzzleFlash,
+    Sparks,
+    EnemyDebris,
+    WoodDebris, // Destroyed destructible
+    Count
+};
+
+// Cosmetic particles. Storage is structure-of-arrays with a fixed capacity
+// allocated up front: the update is a straight pass over contiguous float
+// arrays, and spawning or killing never allocates (past the capacity new
+// particles are dropped and counted).
+class ParticleSystem
+{
+public:
+    static constexpr std::size_t MaxParticles = 1 << 18;
+    static constexpr std::size_t MaxEmitters = 256;
+
+private:
+    // One entry per live particle, [0, count)
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> age;     // 0 at birth, dead at 1
+    std::vector<float> ageRate; // 1 / lifetime
+    std::vector<float> size;
+    std::vector<std::uint32_t> color;
+    std::size_t count;
+    std::uint64_t dropped;
+
+    // Emitters keep spawning for a while after the event (debris); a fixed
+    // pool, finished ones are swapped out
+    struct Emitter
+    {
+        EffectType type;
+        sf::Vector2<float> position;
+        sf::Vector2<float> direction;
+        float remaining; // Seconds
+        float carry;     // Fractional particles owed from the last update
+    };
+    std::array<Emitter, MaxEmitters> emitters;
+    std::size_t emitterCount;
+
+    std::uint32_t rngState;
+    ProjectileRenderer discs;
+    std::vector<sf::Vertex> quads; // Fallback without geometry shaders
+
+    float random(float min, float max);
+    void spawn(EffectType type, sf::Vector2<float> position, sf::Vector2<float> direction, std::size_t amount);
+
+public:
+    ParticleSystem();
+
+    // Needs a GL context; without it particles are drawn as plain quads
+    bool createRenderer() { return discs.create(); }
+
+    // 'direction' need not be normalized; zero sprays in every direction
+    void emit(EffectType type, sf::Vector2<float> position, sf::Vector2<float> direction = {});
+
+    void update(float dt);
+
+    // One draw call for every live particle overlapping 'visible'
+    void draw(sf::RenderTarget &target, const sf::Rect<float> &visible);
+
+    std::size_t getCount() const { return count; }
+    std::uint64_t getDropped() const { return dropped; }
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+// One tick of player input, decoupled from the keyboard and mouse so the
+// simulation can also be driven by the network or a bot
+struct PlayerInput
+{
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+    bool shoot = false;
+    sf::Vector2<float> aim; // World-space target, only meaningful when shooting
+};
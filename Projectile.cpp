@@ -29,10 +29,36 @@ void Projectile::update(float dt)
     }
 }
 
-void Projectile::render(sf::RenderWindow &window)
+void Projectile::hashState(StateHash &hash) const
 {
-    sf::CircleShape shape(size.x / 2);
-    shape.setPosition(position);
-    shape.setFillColor(color);
-    window.draw(shape);
+    GameObject::hashState(hash);
+    hash.add(velocity);
+    hash.add(age);
+}
+
+void Projectile::saveState(ProjectileRecord &record) const
+{
+    GameObject::saveState(record.object);
+    record.vx = velocity.x;
+    record.vy = velocity.y;
+    record.speed = speed;
+    record.color = color.toInteger();
+    record.lifetime = lifetime;
+    record.age = age;
+}
+
+void Projectile::loadState(const ProjectileRecord &record)
+{
+    GameObject::loadState(record.object);
+    velocity = sf::Vector2<float>(record.vx, record.vy);
+    speed = record.speed;
+    color = sf::Color(record.color);
+    lifetime = record.lifetime;
+    age = record.age;
+}
+
+void Projectile::render(RenderQueue &queue) const
+{
+    // Falls back to the disc sprite, the old sf::CircleShape look
+    queue.draw(getSprite(), getBounds(), color, RenderLayer::Projectiles);
 }
\ No newline at end of file
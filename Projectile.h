@@ -16,5 +16,10 @@ public:
     virtual ~Projectile() override {}
 
     void update(float dt) override;
-    void render(sf::RenderWindow &window) override;
+    void render(RenderQueue &queue) const override;
+    const sf::Vector2<float> &getVelocity() const { return velocity; }
+    SpriteId getSprite() const override { return SpriteId::Projectile; }
+    void hashState(StateHash &hash) const override;
+    void saveState(ProjectileRecord &record) const;
+    void loadState(const ProjectileRecord &record);
 };
\ No newline at end of file
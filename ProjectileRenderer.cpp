@@ -0,0 +1,96 @@
+#include "ProjectileRenderer.h"
+#include <SFML/Graphics/RenderStates.hpp>
+#include <algorithm>
+
+namespace
+{
+// The compatibility profile keeps the fixed-function matrices and vertex
+// attributes that SFML feeds
+const char *const VertexSource = R"(#version 150 compatibility
+out vec4 discColor;
+out vec2 clipRadius;
+
+void main()
+{
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    discColor = gl_Color;
+    // The view is never rotated, so the radius maps per axis
+    float radius = gl_MultiTexCoord0.x * 0.5;
+    clipRadius = (gl_ModelViewProjectionMatrix * vec4(radius, radius, 0.0, 0.0)).xy;
+}
+)";
+
+const char *const GeometrySource = R"(#version 150 compatibility
+layout (points) in;
+layout (triangle_strip, max_vertices = 4) out;
+
+in vec4 discColor[];
+in vec2 clipRadius[];
+out vec4 color;
+out vec2 local;
+
+void main()
+{
+    vec4 center = gl_in[0].gl_Position;
+    for (int i = 0; i < 4; ++i)
+    {
+        vec2 corner = vec2((i & 1) == 0 ? -1.0 : 1.0, i < 2 ? -1.0 : 1.0);
+        gl_Position = center + vec4(corner * clipRadius[0], 0.0, 0.0);
+        color = discColor[0];
+        local = corner;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+)";
+
+// Same coverage as the atlas disc: one pixel wide anti-aliased edge
+const char *const FragmentSource = R"(#version 150 compatibility
+in vec4 color;
+in vec2 local;
+
+void main()
+{
+    float distance = length(local);
+    float coverage = clamp((1.0 - distance) / max(fwidth(distance), 1e-4) + 0.5, 0.0, 1.0);
+    gl_FragColor = vec4(color.rgb, color.a * coverage);
+}
+)";
+} // namespace
+
+// ============= ProjectileRenderer Implementation =============
+
+ProjectileRenderer::ProjectileRenderer()
+    : buffer(sf::PrimitiveType::Points, sf::VertexBuffer::Usage::Stream), available(false) {}
+
+bool ProjectileRenderer::create()
+{
+    available = sf::Shader::isGeometryAvailable() &&
+                shader.loadFromMemory(VertexSource, GeometrySource, FragmentSource);
+    return available;
+}
+
+void ProjectileRenderer::add(const sf::Rect<float> &rect, sf::Color color)
+{
+    points.push_back({rect.getCenter(), color, {rect.size.x, 0}});
+}
+
+void ProjectileRenderer::draw(sf::RenderTarget &target, const sf::BlendMode &blend)
+{
+    if (points.empty())
+        return;
+
+    sf::RenderStates states;
+    states.shader = &shader;
+    states.blendMode = blend;
+
+    // Without vertex buffers the points are sent from client memory instead
+    bool buffered = sf::VertexBuffer::isAvailable();
+    if (buffered && points.size() > buffer.getVertexCount())
+        buffered = buffer.create(std::max(points.size(), buffer.getVertexCount() * 2));
+    if (buffered && buffer.update(points.data(), points.size(), 0))
+        target.draw(buffer, 0, points.size(), states);
+    else
+        target.draw(points.data(), points.size(), sf::PrimitiveType::Points, states);
+    points.clear();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <cstddef>
+#include <vector>
+
+// Draws projectiles as one point each (centre, colour, and the diameter in
+// texCoords.x), the way SFML's geometry shader example draws billboards: a
+// geometry shader expands every point into a quad and the fragment shader
+// rasterizes an anti-aliased disc in it. 100k projectiles upload 2 MB and
+// cost one draw call.
+class ProjectileRenderer
+{
+private:
+    sf::Shader shader;
+    sf::VertexBuffer buffer; // Points, streamed; grown by doubling
+    std::vector<sf::Vertex> points;
+    bool available;
+
+public:
+    ProjectileRenderer();
+
+    // Needs a GL context. Returns false when geometry shaders are missing;
+    // callers then keep drawing projectiles as sprites.
+    bool create();
+    bool isAvailable() const { return available; }
+
+    void add(const sf::Rect<float> &rect, sf::Color color);
+    std::size_t getCount() const { return points.size(); }
+
+    // Uploads and draws everything added since the last call
+    void draw(sf::RenderTarget &target, const sf::BlendMode &blend = sf::BlendAlpha);
+};
@@ -0,0 +1,99 @@
+#include "RenderBench.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "Camera.h"
+#include "RenderQueue.h"
+#include "Visibility.h"
+#include "World.h"
+
+// ============= Headless render benchmark =============
+
+int runRenderBenchmark(const GameOptions &options)
+{
+    std::shared_ptr<const Level> level = loadLevelOrBuiltin(options.levelPath);
+    if (!level)
+        return 1;
+
+    std::unique_ptr<ChunkStreamer> streamer = createChunkStreamer(level, options.chunkCacheMb);
+    World world(level, streamer.get());
+
+    // Never uploaded: every sprite maps to page 0, which is all the null
+    // backend needs to count draw calls
+    TextureAtlas atlas;
+    RenderQueue queue(atlas);
+    NullRenderBackend backend;
+    Camera camera({800, 600});
+    camera.setBounds(level->getBounds());
+
+    VisibilityPolygon sight;
+    PlayerInput input;
+    double recordSeconds = 0, submitSeconds = 0, sightSeconds = 0, worstSight = 0;
+    std::uint64_t sightUpdates = 0, sightEdges = 0, checkedRays = 0, mismatchedRays = 0;
+    std::vector<sf::Rect<float>> walls; // Scratch for the ray cross-check
+    sf::Clock clock;
+
+    for (int frame = 0; frame < options.renderBenchFrames; ++frame)
+    {
+        // Same script as the load test: strafe in a square, fire at an enemy
+        int phase = (frame / 60) % 4;
+        input.up = phase == 0;
+        input.right = phase == 1;
+        input.down = phase == 2;
+        input.left = phase == 3;
+        input.shoot = (frame % 15) == 0 && !world.getEnemies().empty();
+        if (input.shoot)
+            input.aim = world.getEnemies().front()->getPosition();
+        world.update(input, World::FixedDt);
+
+        clock.restart();
+        camera.follow(world.getPlayer().getBounds().getCenter());
+        world.render(queue, camera.getVisibleArea());
+        recordSeconds += clock.restart().asSeconds();
+        queue.flush(backend);
+        submitSeconds += clock.restart().asSeconds();
+
+        // As with --fog: only recomputed when the player or the view moved
+        if (sight.update(world, world.getPlayer().getBounds().getCenter(), camera.getVisibleArea()))
+        {
+            double seconds = clock.getElapsedTime().asSeconds();
+            sightSeconds += seconds;
+            worstSight = std::max(worstSight, seconds);
+            ++sightUpdates;
+            sightEdges += sight.getEdgeCount();
+
+            // Every so often, check the sweep against brute-force ray casts
+            // (untimed: it is far slower than the sweep)
+            if (sightUpdates % 16 == 1)
+            {
+                constexpr std::uint32_t Rays = 720;
+                walls.clear();
+                world.queryWalls(camera.getVisibleArea(), walls);
+                checkedRays += Rays;
+                mismatchedRays += sight.countRayMismatches(walls, Rays);
+            }
+        }
+    }
+
+    double frames = static_cast<double>(backend.getFrames());
+    std::cout << "Render benchmark: " << backend.getFrames() << " frames, "
+              << static_cast<double>(backend.getCommands()) / frames << " commands and "
+              << static_cast<double>(backend.getDrawCalls()) / frames << " draw calls per frame\n"
+              << "  cull + record " << recordSeconds * 1e6 / frames << " us/frame, sort + submit "
+              << submitSeconds * 1e6 / frames << " us/frame\n";
+    if (sightUpdates > 0)
+        std::cout << "  line of sight: " << sightUpdates << " recomputes, "
+                  << static_cast<double>(sightEdges) / static_cast<double>(sightUpdates) << " edges and "
+                  << sightSeconds * 1e6 / static_cast<double>(sightUpdates) << " us each, worst "
+                  << worstSight * 1e6 << " us\n"
+                  << "  ray check: " << mismatchedRays << " of " << checkedRays << " rays disagree\n";
+    if (streamer)
+        streamer->printStats(std::cout);
+    if (mismatchedRays > 0)
+    {
+        std::cerr << "Line of sight disagrees with ray casts on " << mismatchedRays << " rays\n";
+        return 1;
+    }
+    return 0;
+}
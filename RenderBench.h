@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Options.h"
+
+// Headless: simulates options.renderBenchFrames fixed ticks of scripted play
+// and pushes every frame through culling, command recording and sorting into
+// a NullRenderBackend. Needs no window or GPU; reports per-frame costs.
+int runRenderBenchmark(const GameOptions &options);
@@ -0,0 +1,40 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+// ============= NullRenderBackend Implementation =============
+
+NullRenderBackend::NullRenderBackend() : frames(0), commands(0), drawCalls(0) {}
+
+void NullRenderBackend::submit(std::span<const DrawCommand> sorted)
+{
+    ++frames;
+    commands += sorted.size();
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+        if (i == 0 || sorted[i].getState() != sorted[i - 1].getState())
+            ++drawCalls;
+}
+
+// ============= RenderQueue Implementation =============
+
+RenderQueue::RenderQueue(const TextureAtlas &textures) : atlas(textures), sequence(0) {}
+
+void RenderQueue::draw(SpriteId sprite, const sf::Rect<float> &rect, sf::Color color, RenderLayer layer, BlendMode blend)
+{
+    std::uint64_t key = std::uint64_t(static_cast<std::uint8_t>(layer)) << 56 |
+                        std::uint64_t(atlas.get(sprite).page & 0xFFFF) << 40 |
+                        std::uint64_t(static_cast<std::uint8_t>(blend)) << 32 | sequence++;
+    commands.push_back({key, rect, color.toInteger(), sprite});
+}
+
+void RenderQueue::flush(RenderBackend &backend, RenderLayer through)
+{
+    // Keys are unique (the sequence), so the order is fully determined
+    std::sort(commands.begin(), commands.end(), [](const DrawCommand &a, const DrawCommand &b)
+              { return a.key < b.key; });
+    auto end = std::partition_point(commands.begin(), commands.end(), [through](const DrawCommand &command)
+                                    { return command.getLayer() <= through; });
+    backend.submit(std::span<const DrawCommand>(commands.data(), static_cast<std::size_t>(end - commands.begin())));
+    commands.erase(commands.begin(), end);
+    if (commands.empty())
+        sequence = 0;
+}
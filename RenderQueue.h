@@ -0,0 +1,93 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "TextureAtlas.h"
+
+// Draw order between groups of objects; the queue is sorted by it first
+enum class RenderLayer : std::uint8_t
+{
+    Static,      // Walls, destructibles
+    Actors,      // Player, enemies
+    Projectiles,
+    Effects,
+    Hud
+};
+
+enum class BlendMode : std::uint8_t
+{
+    Alpha,
+    Add
+};
+
+// One textured quad. The sort key packs, from the top bit down:
+// layer (8) | atlas page (16) | blend (8) | sequence (32), so sorting groups
+// by layer, then by texture and blend state, and keeps submission order
+// among equal states.
+struct DrawCommand
+{
+    std::uint64_t key;
+    sf::Rect<float> rect; // World space; sprites are never rotated
+    std::uint32_t color;  // sf::Color::toInteger()
+    SpriteId sprite;
+
+    RenderLayer getLayer() const { return static_cast<RenderLayer>(key >> 56); }
+    std::uint32_t getPage() const { return static_cast<std::uint32_t>(key >> 40) & 0xFFFF; }
+    BlendMode getBlend() const { return static_cast<BlendMode>((key >> 32) & 0xFF); }
+    // Page and blend: a backend needs a new draw call whenever this changes
+    std::uint32_t getState() const { return static_cast<std::uint32_t>(key >> 32) & 0xFFFFFF; }
+};
+
+// Consumes a sorted command list
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+    virtual void submit(std::span<const DrawCommand> commands) = 0;
+};
+
+// Only counts, so the render path can be measured without a GPU
+class NullRenderBackend : public RenderBackend
+{
+private:
+    std::uint64_t frames;
+    std::uint64_t commands;
+    std::uint64_t drawCalls;
+
+public:
+    NullRenderBackend();
+    void submit(std::span<const DrawCommand> sorted) override;
+
+    std::uint64_t getFrames() const { return frames; }
+    std::uint64_t getCommands() const { return commands; }
+    std::uint64_t getDrawCalls() const { return drawCalls; }
+};
+
+// Commands recorded by render() methods during one frame. Capacity is kept
+// across frames, so steady-state recording does not allocate.
+class RenderQueue
+{
+private:
+    const TextureAtlas &atlas;
+    std::vector<DrawCommand> commands;
+    std::uint32_t sequence;
+
+public:
+    // 'textures' is only read for each sprite's page; it may still be empty
+    explicit RenderQueue(const TextureAtlas &textures);
+
+    // 'color' tints flat and disc sprites; image sprites draw unmodified
+    void draw(SpriteId sprite, const sf::Rect<float> &rect, sf::Color color, RenderLayer layer,
+              BlendMode blend = BlendMode::Alpha);
+
+    // Sorts, hands the commands up to and including layer 'through' to
+    // 'backend', then drops them. Flushing in steps lets other drawing
+    // (particles) go between layers.
+    void flush(RenderBackend &backend, RenderLayer through = RenderLayer::Hud);
+
+    std::size_t getCount() const { return commands.size(); }
+};
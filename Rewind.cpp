@@ -0,0 +1,290 @@
+#include "Rewind.h"
+#include "World.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+constexpr std::size_t MaxRun = 0xFFFF;
+
+void writeU16(std::uint8_t *out, std::size_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value);
+    out[1] = static_cast<std::uint8_t>(value >> 8);
+}
+
+std::size_t readU16(const std::uint8_t *in) { return std::size_t(in[0]) | (std::size_t(in[1]) << 8); }
+} // namespace
+
+// ============= RewindBuffer Implementation =============
+
+RewindBuffer::RewindBuffer(std::size_t budgetBytes, std::uint32_t maxTicks, std::uint32_t interval)
+    : arena(budgetBytes), head(0), frames(std::max<std::uint32_t>(maxTicks, 1)), first(0), count(0),
+      keyframeInterval(std::max<std::uint32_t>(interval, 1)), sinceKeyframe(0), forceKeyframe(true) {}
+
+void RewindBuffer::clear()
+{
+    head = 0;
+    first = 0;
+    count = 0;
+    forceKeyframe = true;
+}
+
+std::size_t RewindBuffer::getBytesUsed() const
+{
+    if (count == 0)
+        return 0;
+    std::size_t tail = frameAt(0).offset;
+    return head > tail ? head - tail : arena.size() - tail + head;
+}
+
+bool RewindBuffer::findFrame(std::uint32_t tick, std::size_t &index) const
+{
+    // Ticks only increase along the ring, though restores can leave gaps
+    std::size_t lo = 0, hi = count;
+    while (lo < hi)
+    {
+        std::size_t mid = (lo + hi) / 2;
+        if (frameAt(mid).tick < tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    index = lo;
+    return lo < count && frameAt(lo).tick == tick;
+}
+
+bool RewindBuffer::encodeDelta(const WorldSnapshot &from, const WorldSnapshot &to, std::size_t &size)
+{
+    // Give up as soon as the delta would not beat a raw keyframe
+    const std::size_t limit = to.getSize();
+    if (encoded.size() < limit)
+        encoded.resize(limit);
+
+    const std::uint8_t *a = from.getData();
+    const std::uint8_t *b = to.getData();
+    const std::size_t common = std::min(from.getSize(), to.getSize());
+    auto diff = [&](std::size_t i)
+    { return static_cast<std::uint8_t>(b[i] ^ (i < common ? a[i] : 0)); };
+
+    std::size_t out = 0;
+    std::size_t i = 0;
+    while (i < limit)
+    {
+        std::size_t unchanged = 0;
+        while (i + unchanged < limit && unchanged < MaxRun && diff(i + unchanged) == 0)
+            ++unchanged;
+        i += unchanged;
+        if (i == limit)
+            break; // Trailing unchanged bytes need no run
+
+        std::size_t changed = 0;
+        while (i + changed < limit && changed < MaxRun && diff(i + changed) != 0)
+            ++changed;
+        if (out + 4 + changed >= limit)
+            return false;
+
+        writeU16(&encoded[out], unchanged);
+        writeU16(&encoded[out + 2], changed);
+        for (std::size_t k = 0; k < changed; ++k)
+            encoded[out + 4 + k] = diff(i + k);
+        out += 4 + changed;
+        i += changed;
+    }
+
+    size = out;
+    return true;
+}
+
+void RewindBuffer::applyDelta(const std::uint8_t *delta, std::size_t size, WorldSnapshot &state)
+{
+    std::uint8_t *bytes = state.getData();
+    std::size_t at = 0;
+    for (std::size_t in = 0; in + 4 <= size;)
+    {
+        at += readU16(delta + in);
+        std::size_t changed = readU16(delta + in + 2);
+        in += 4;
+        for (std::size_t k = 0; k < changed; ++k)
+            bytes[at + k] ^= delta[in + k];
+        at += changed;
+        in += changed;
+    }
+}
+
+void RewindBuffer::dropOldestGroup()
+{
+    // A delta is useless without its keyframe, so they go together
+    do
+    {
+        first = (first + 1) % frames.size();
+        --count;
+    } while (count > 0 && !frameAt(0).keyframe);
+
+    if (count == 0)
+        clear();
+}
+
+void RewindBuffer::dropFrom(std::uint32_t tick)
+{
+    while (count > 0 && frameAt(count - 1).tick >= tick)
+    {
+        head = frameAt(count - 1).offset;
+        --count;
+    }
+    if (count == 0)
+        clear();
+    forceKeyframe = true; // 'previous' no longer matches the newest frame
+}
+
+bool RewindBuffer::allocate(std::size_t size, std::size_t &offset)
+{
+    if (size > arena.size())
+        return false;
+
+    // Live bytes run from the oldest frame's offset up to 'head', possibly
+    // wrapping; head == tail with frames present means the arena is full
+    for (;;)
+    {
+        if (count == 0)
+        {
+            offset = 0;
+            head = size;
+            return true;
+        }
+
+        std::size_t tail = frameAt(0).offset;
+        if (head > tail)
+        {
+            if (arena.size() - head >= size)
+            {
+                offset = head;
+                head += size;
+                return true;
+            }
+            if (tail >= size)
+            {
+                offset = 0;
+                head = size;
+                return true;
+            }
+        }
+        else if (head < tail && tail - head >= size)
+        {
+            offset = head;
+            head += size;
+            return true;
+        }
+        dropOldestGroup();
+    }
+}
+
+void RewindBuffer::record(const World &world, const PlayerInput &input)
+{
+    std::uint32_t tick = world.getTick();
+    if (count > 0 && tick <= getNewestTick())
+        dropFrom(tick);
+    if (count > 0 && tick != getNewestTick() + 1)
+        forceKeyframe = true;
+
+    world.saveSnapshot(current);
+
+    std::size_t deltaSize = 0;
+    bool keyframe = forceKeyframe || count == 0 || sinceKeyframe >= keyframeInterval ||
+                    !encodeDelta(previous, current, deltaSize);
+
+    if (count == frames.size())
+        dropOldestGroup();
+
+    std::size_t offset = 0;
+    if (!allocate(keyframe ? current.getSize() : deltaSize, offset))
+    {
+        std::cerr << "Rewind budget of " << arena.size() << " bytes is smaller than one snapshot\n";
+        clear();
+        return;
+    }
+    if (!keyframe && count == 0)
+    {
+        // Making room evicted this delta's own keyframe
+        keyframe = true;
+        if (!allocate(current.getSize(), offset))
+        {
+            clear();
+            return;
+        }
+    }
+
+    std::memcpy(arena.data() + offset, keyframe ? current.getData() : encoded.data(),
+                keyframe ? current.getSize() : deltaSize);
+
+    Frame &frame = frames[(first + count) % frames.size()];
+    frame.tick = tick;
+    frame.input = input;
+    frame.offset = offset;
+    frame.size = keyframe ? current.getSize() : deltaSize;
+    frame.snapshotSize = static_cast<std::uint32_t>(current.getSize());
+    frame.keyframe = keyframe;
+    ++count;
+
+    sinceKeyframe = keyframe ? 1 : sinceKeyframe + 1;
+    forceKeyframe = false;
+    std::swap(previous, current); // Swaps buffers, keeping both capacities
+}
+
+bool RewindBuffer::restore(World &world, std::uint32_t tick)
+{
+    std::size_t index = 0;
+    if (!findFrame(tick, index))
+        return false;
+
+    std::size_t key = index;
+    while (!frameAt(key).keyframe)
+        --key; // Always terminates: the oldest frame is a keyframe
+
+    const Frame &keyFrame = frameAt(key);
+    decoded.resize(keyFrame.snapshotSize);
+    std::memcpy(decoded.getData(), arena.data() + keyFrame.offset, keyFrame.size);
+
+    for (std::size_t i = key + 1; i <= index; ++i)
+    {
+        const Frame &frame = frameAt(i);
+        decoded.resize(frame.snapshotSize); // Growth is zero-filled, matching the encoder
+        applyDelta(arena.data() + frame.offset, frame.size, decoded);
+    }
+    return world.loadSnapshot(decoded);
+}
+
+bool RewindBuffer::setInput(std::uint32_t tick, const PlayerInput &input)
+{
+    std::size_t index = 0;
+    if (!findFrame(tick, index))
+        return false;
+    frameAt(index).input = input;
+    return true;
+}
+
+bool RewindBuffer::resimulate(World &world, std::uint32_t fromTick, std::uint32_t toTick)
+{
+    std::size_t index = 0;
+    if (toTick < fromTick || !findFrame(fromTick, index))
+        return false;
+
+    // Copy the inputs out first: re-recording drops the frames they live in
+    replayInputs.clear();
+    for (std::size_t i = index; i < count && frameAt(i).tick < toTick; ++i)
+    {
+        if (frameAt(i).tick != fromTick + replayInputs.size())
+            return false; // Gap left by an earlier restore
+        replayInputs.push_back(frameAt(i).input);
+    }
+    if (fromTick + replayInputs.size() != toTick || !restore(world, fromTick))
+        return false;
+
+    for (const PlayerInput &input : replayInputs)
+    {
+        record(world, input);
+        world.update(input, World::FixedDt);
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PlayerInput.h"
+#include "Snapshot.h"
+
+class World;
+
+// Ring of recent world states for debugging rewinds and rollback.
+//
+// Every tick stores the input applied from it and the state it started from.
+// Most states are deltas: the snapshot bytes XORed with the previous tick's,
+// stored as (u16 unchanged, u16 changed, changed bytes...) runs. Every
+// 'keyframeInterval' ticks, or when a delta would not be smaller, the raw
+// snapshot is stored instead. All of it lives in one arena sized up front;
+// when it or the tick ring is full, the oldest keyframe and its deltas are
+// dropped together. Nothing is allocated per tick once the scratch buffers
+// have grown to the world's size.
+class RewindBuffer
+{
+private:
+    struct Frame
+    {
+        std::uint32_t tick;
+        PlayerInput input;
+        std::size_t offset; // Into the arena
+        std::size_t size;
+        std::uint32_t snapshotSize;
+        bool keyframe;
+    };
+
+    std::vector<std::uint8_t> arena;
+    std::size_t head; // Next free arena byte (when not empty)
+    std::vector<Frame> frames;
+    std::size_t first;
+    std::size_t count;
+    std::uint32_t keyframeInterval;
+    std::uint32_t sinceKeyframe;
+    bool forceKeyframe;
+
+    WorldSnapshot previous; // State recorded last, for the next delta
+    WorldSnapshot current;
+    WorldSnapshot decoded;  // Scratch for restore()
+    std::vector<std::uint8_t> encoded;
+    std::vector<PlayerInput> replayInputs; // Scratch for resimulate()
+
+    Frame &frameAt(std::size_t i) { return frames[(first + i) % frames.size()]; }
+    const Frame &frameAt(std::size_t i) const { return frames[(first + i) % frames.size()]; }
+
+    bool findFrame(std::uint32_t tick, std::size_t &index) const;
+    bool encodeDelta(const WorldSnapshot &from, const WorldSnapshot &to, std::size_t &size);
+    static void applyDelta(const std::uint8_t *delta, std::size_t size, WorldSnapshot &state);
+    bool allocate(std::size_t size, std::size_t &offset);
+    void dropOldestGroup();
+    void dropFrom(std::uint32_t tick);
+
+public:
+    RewindBuffer(std::size_t budgetBytes, std::uint32_t maxTicks, std::uint32_t keyframeInterval = 30);
+
+    // Call before world.update(input). Recording a tick at or before the
+    // newest one (after a restore) discards the frames from there on.
+    void record(const World &world, const PlayerInput &input);
+
+    // Puts 'world' back to the start of 'tick'; false if it is not held
+    bool restore(World &world, std::uint32_t tick);
+
+    // Restores 'fromTick' and replays the recorded inputs up to 'toTick',
+    // re-recording each tick so later restores see the new states. Rollback
+    // netcode corrects late inputs with setInput() first.
+    bool resimulate(World &world, std::uint32_t fromTick, std::uint32_t toTick);
+    bool setInput(std::uint32_t tick, const PlayerInput &input);
+
+    void clear();
+    bool isEmpty() const { return count == 0; }
+    std::uint32_t getOldestTick() const { return count ? frameAt(0).tick : 0; }
+    std::uint32_t getNewestTick() const { return count ? frameAt(count - 1).tick : 0; }
+    std::size_t getBytesUsed() const;
+    std::size_t getBudget() const { return arena.size(); }
+};
@@ -0,0 +1,570 @@
+#include "Server.h"
+#include "NetProtocol.h"
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <random>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace
+{
+constexpr float TickDt = World::FixedDt;
+constexpr float ViewRadius = 600.0f;
+constexpr std::size_t StateBudgetBytes = 1200; // Keeps State packets under a typical MTU
+constexpr std::size_t MaxClientsPerMatch = 8;
+constexpr std::uint32_t ClientTimeoutTicks = static_cast<std::uint32_t>(10.0f / TickDt); // 10 s of silence
+
+std::uint64_t mix(std::uint64_t x)
+{
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Stateless join cookie: a sender can only echo it if it receives packets
+// at that address and port, and a pending join costs the server no memory
+std::uint64_t joinNonce(std::uint64_t secret, const sf::IpAddress &address, unsigned short port, std::uint32_t matchId)
+{
+    std::uint64_t endpoint = (std::uint64_t(address.toInteger()) << 16) | port;
+    return mix(mix(secret ^ endpoint) ^ matchId);
+}
+
+void pinCurrentThread(unsigned int core)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (core % 64));
+#else
+    (void)core; // Affinity is only a hint; run unpinned elsewhere
+#endif
+}
+
+// Set from a signal handler, polled by runServer()
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+// Ports are handed out consecutively from --port; none may wrap past 65535
+bool portsFit(const GameOptions &options, unsigned int count)
+{
+    if (options.port + count - 1 <= 65535)
+        return true;
+    std::cerr << "--port " << options.port << " leaves no room for " << count << " consecutive ports\n";
+    return false;
+}
+
+unsigned int shardCountFor(const GameOptions &options, int matchCount)
+{
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int shards = options.shards > 0 ? static_cast<unsigned int>(options.shards) : cores;
+    return std::max(1u, std::min(shards, static_cast<unsigned int>(std::max(matchCount, 1))));
+}
+
+// Matches are dealt round-robin so that shard == matchId % shardCount. All
+// matches share the one read-only level mapping.
+std::vector<std::unique_ptr<ServerShard>> createShards(unsigned int shardCount, int matchCount,
+                                                       const std::shared_ptr<const Level> &level)
+{
+    std::vector<std::unique_ptr<ServerShard>> shards;
+    for (unsigned int i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<ServerShard>(i));
+    for (int m = 0; m < matchCount; ++m)
+        shards[static_cast<unsigned int>(m) % shardCount]->addMatch(static_cast<std::uint32_t>(m), level);
+    return shards;
+}
+} // namespace
+
+// ============= Match Implementation =============
+
+Match::Match(std::uint32_t id, std::shared_ptr<const Level> level)
+    : matchId(id), world(std::move(level)), interest(256.0f), tick(0) {}
+
+Match::Client *Match::findClient(const sf::IpAddress &address, unsigned short port)
+{
+    for (Client &client : clients)
+        if (client.address == address && client.port == port)
+            return &client;
+    return nullptr;
+}
+
+void Match::addClient(const sf::IpAddress &address, unsigned short port)
+{
+    if (Client *client = findClient(address, port))
+    {
+        client->lastHeard = tick; // Its first State was probably lost
+        return;
+    }
+    if (clients.size() >= MaxClientsPerMatch)
+        return;
+
+    clients.push_back({address, port, interest.addClient(ViewRadius, StateBudgetBytes), tick});
+}
+
+void Match::setInput(const sf::IpAddress &address, unsigned short port, const PlayerInput &newInput)
+{
+    Client *client = findClient(address, port);
+    if (!client)
+        return;
+    client->lastHeard = tick;
+    input = newInput;
+}
+
+void Match::useBotInput()
+{
+    // Scripted input for load tests: strafe in a square and fire at the nearest enemy
+    std::uint32_t phase = (tick / 60) % 4;
+    input.up = phase == 0;
+    input.right = phase == 1;
+    input.down = phase == 2;
+    input.left = phase == 3;
+
+    input.shoot = (tick % 15) == 0 && !world.getEnemies().empty();
+    if (input.shoot)
+        input.aim = world.getEnemies().front()->getPosition();
+}
+
+void Match::step(float dt)
+{
+    world.update(input, dt);
+    input.shoot = false;
+    ++tick;
+}
+
+void Match::gatherReplicated()
+{
+    replicated.clear();
+
+    const Player &player = world.getPlayer();
+    replicated.push_back({player.getId(), player.getPosition(), 4.0f, StateEntityBytes,
+                          static_cast<std::uint8_t>(EntityKind::Player)});
+    for (const auto &enemy : world.getEnemies())
+        replicated.push_back({enemy->getId(), enemy->getPosition(), 2.0f, StateEntityBytes,
+                              static_cast<std::uint8_t>(EntityKind::Enemy)});
+    for (const auto &proj : world.getProjectiles())
+        replicated.push_back({proj->getId(), proj->getPosition(), 1.0f, StateEntityBytes,
+                              static_cast<std::uint8_t>(EntityKind::Projectile)});
+    for (const auto &dest : world.getDestructibles())
+        replicated.push_back({dest.getId(), dest.getPosition(), 0.5f, StateEntityBytes,
+                              static_cast<std::uint8_t>(EntityKind::Destructible)});
+}
+
+void Match::replicate(Transport &transport)
+{
+    // Clients that went quiet (closed, crashed, moved address) stop costing
+    // bandwidth and relevance work
+    std::erase_if(clients, [this](const Client &client)
+                  {
+                      if (tick - client.lastHeard <= ClientTimeoutTicks)
+                          return false;
+                      interest.removeClient(client.interestId);
+                      return true; });
+
+    if (clients.empty())
+        return;
+
+    gatherReplicated();
+    interest.beginTick(replicated);
+    if (!firstStateTick)
+        firstStateTick = tick;
+
+    for (const Client &client : clients)
+    {
+        interest.setClientView(client.interestId, world.getPlayer().getPosition());
+        const std::vector<std::uint32_t> &selected = interest.selectForClient(client.interestId);
+
+        sf::Packet packet;
+        packet << static_cast<std::uint8_t>(PacketType::State) << matchId << tick
+               << static_cast<std::uint16_t>(selected.size());
+        for (std::uint32_t index : selected)
+        {
+            const ReplicatedEntity &entity = replicated[index];
+            packet << entity.id << entity.kind << entity.position.x << entity.position.y;
+        }
+
+        // Unreliable: a dropped State is superseded by the next one
+        transport.send(packet, client.address, client.port);
+    }
+}
+
+// ============= ServerShard Implementation =============
+
+ServerShard::ServerShard(unsigned int shardIndex)
+    : index(shardIndex), running(false), ticks(0)
+{
+    std::random_device seed;
+    joinSecret = (std::uint64_t(seed()) << 32) | seed();
+}
+
+ServerShard::~ServerShard() { stop(); }
+
+void ServerShard::addMatch(std::uint32_t matchId, const std::shared_ptr<const Level> &level)
+{
+    matches.push_back(std::make_unique<Match>(matchId, level));
+    matchById[matchId] = matches.back().get();
+}
+
+const Match *ServerShard::findMatch(std::uint32_t matchId) const
+{
+    auto it = matchById.find(matchId);
+    return it != matchById.end() ? it->second : nullptr;
+}
+
+bool ServerShard::bind(unsigned short port, const NetConditions &conditions)
+{
+    auto udp = std::make_unique<UdpTransport>();
+    if (!udp->bind(port))
+    {
+        std::cerr << "Shard " << index << ": cannot bind UDP port " << port << "\n";
+        return false;
+    }
+    transport = applyConditions(std::move(udp), conditions);
+    return true;
+}
+
+void ServerShard::start(bool loadTest)
+{
+    running = true;
+    thread = std::thread([this, loadTest]
+                         {
+                             pinCurrentThread(index);
+                             if (loadTest)
+                                 runLoadTest();
+                             else
+                                 runServer(); });
+}
+
+void ServerShard::stop()
+{
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+void ServerShard::receivePackets()
+{
+    sf::Packet packet;
+    std::optional<sf::IpAddress> sender;
+    unsigned short senderPort = 0;
+
+    while (transport->receive(packet, sender, senderPort))
+    {
+        std::uint8_t type = 0;
+        std::uint32_t matchId = 0;
+        if (!sender || !(packet >> type >> matchId))
+            continue;
+
+        auto it = matchById.find(matchId);
+        if (it == matchById.end())
+            continue; // Wrong shard or unknown match
+
+        if (type == static_cast<std::uint8_t>(PacketType::Join))
+        {
+            // A Join without the right nonce is answered with it, so State
+            // only ever goes to an address that proved it receives our
+            // packets. Challenge and Join are the same size: a spoofed Join
+            // cannot use the server as an amplifier.
+            std::uint64_t nonce = 0;
+            if (!(packet >> nonce))
+                continue;
+            std::uint64_t expected = joinNonce(joinSecret, *sender, senderPort, matchId);
+            if (nonce == expected)
+            {
+                it->second->addClient(*sender, senderPort);
+            }
+            else
+            {
+                sf::Packet challenge;
+                challenge << static_cast<std::uint8_t>(PacketType::Challenge) << matchId << expected;
+                transport->send(challenge, *sender, senderPort);
+            }
+        }
+        else if (type == static_cast<std::uint8_t>(PacketType::Input))
+        {
+            std::uint32_t clientTick = 0;
+            std::uint8_t buttons = 0;
+            PlayerInput input;
+            if (packet >> clientTick >> buttons >> input.aim.x >> input.aim.y)
+            {
+                unpackButtons(buttons, input);
+                it->second->setInput(*sender, senderPort, input);
+            }
+        }
+    }
+}
+
+void ServerShard::runServer()
+{
+    sf::Clock clock;
+    sf::Time next = clock.getElapsedTime();
+    const sf::Time step = sf::seconds(TickDt);
+
+    while (running)
+    {
+        if (transport)
+            receivePackets();
+
+        for (auto &match : matches)
+        {
+            match->step(TickDt);
+            if (transport)
+                match->replicate(*transport);
+        }
+        ticks.fetch_add(1, std::memory_order_relaxed);
+
+        next += step;
+        sf::Time now = clock.getElapsedTime();
+        if (next > now)
+            sf::sleep(next - now);
+        else
+            next = now; // Overloaded: do not try to catch up with a burst
+    }
+}
+
+void ServerShard::runLoadTest()
+{
+    // Step as fast as possible; one shard tick advances every match it owns
+    while (running)
+    {
+        for (auto &match : matches)
+        {
+            match->useBotInput();
+            match->step(TickDt);
+        }
+        ticks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ============= Headless entry points =============
+
+int runLoadTest(const GameOptions &options)
+{
+    unsigned int shardCount = shardCountFor(options, options.loadTestMatches);
+    std::shared_ptr<const Level> level = loadLevelOrBuiltin(options.levelPath);
+    if (!level)
+        return 1;
+    auto shards = createShards(shardCount, options.loadTestMatches, level);
+
+    std::cout << "Load test: " << options.loadTestMatches << " matches on "
+              << shardCount << " pinned worker threads for "
+              << options.loadTestSeconds << " s\n";
+
+    sf::Clock clock;
+    for (auto &shard : shards)
+        shard->start(true);
+    sf::sleep(sf::seconds(options.loadTestSeconds));
+    for (auto &shard : shards)
+        shard->stop();
+    float seconds = clock.getElapsedTime().asSeconds();
+
+    double totalMatchTicks = 0;
+    for (const auto &shard : shards)
+    {
+        double shardTicks = static_cast<double>(shard->getTicks());
+        double matchTicks = shardTicks * static_cast<double>(shard->getMatchCount());
+        totalMatchTicks += matchTicks;
+        std::cout << "  core " << shard->getIndex() << ": " << shard->getMatchCount()
+                  << " matches, " << matchTicks / seconds << " match ticks/sec ("
+                  << shardTicks / seconds << " shard ticks/sec)\n";
+    }
+    std::cout << "Total: " << totalMatchTicks / seconds << " match ticks/sec, "
+              << totalMatchTicks / seconds / shardCount << " per core\n";
+    return 0;
+}
+
+int runServer(const GameOptions &options)
+{
+    unsigned int shardCount = shardCountFor(options, options.serverMatches);
+    if (!portsFit(options, shardCount))
+        return 1;
+    std::shared_ptr<const Level> level = loadLevelOrBuiltin(options.levelPath);
+    if (!level)
+        return 1;
+    auto shards = createShards(shardCount, options.serverMatches, level);
+
+    for (auto &shard : shards)
+    {
+        unsigned short port = static_cast<unsigned short>(options.port + shard->getIndex());
+        if (!shard->bind(port, options.net))
+            return 1;
+    }
+
+    std::cout << "Serving " << options.serverMatches << " matches on " << shardCount
+              << " shards, UDP ports " << options.port << "-"
+              << options.port + shardCount - 1 << " (Ctrl+C to stop)\n";
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    for (auto &shard : shards)
+        shard->start(false);
+
+    while (!stopRequested)
+        sf::sleep(sf::milliseconds(100));
+
+    // Each shard finishes its current tick before its thread is joined
+    for (auto &shard : shards)
+        shard->stop();
+    std::cout << "Server stopped\n";
+    return 0;
+}
+
+int runSoakTest(const GameOptions &options)
+{
+    struct SoakClient
+    {
+        std::unique_ptr<Transport> transport;
+        std::uint32_t matchId;
+        std::uint64_t nonce = 0; // From the server's Challenge
+        std::uint64_t states = 0;
+        std::uint64_t duplicates = 0;
+        std::uint64_t outOfOrder = 0;
+        std::uint32_t lastTick = 0;   // Newest State received
+        std::vector<bool> seenTicks; // By match tick, to tell repeats from late arrivals
+        double lagTicks = 0;
+    };
+
+    // One match per bot client, served over an in-process loopback so soak
+    // runs need no free ports and behave the same on every machine
+    LoopbackNetwork network;
+    unsigned int shardCount = shardCountFor(options, options.soakClients);
+    if (!portsFit(options, shardCount + static_cast<unsigned int>(options.soakClients)))
+        return 1; // Clients take the ports after the shards'
+    std::shared_ptr<const Level> level = loadLevelOrBuiltin(options.levelPath);
+    if (!level)
+        return 1;
+    auto shards = createShards(shardCount, options.soakClients, level);
+
+    for (auto &shard : shards)
+    {
+        unsigned short port = static_cast<unsigned short>(options.port + shard->getIndex());
+        NetConditions serverNet = options.net;
+        serverNet.seed += shard->getIndex();
+        shard->setTransport(applyConditions(std::make_unique<LoopbackTransport>(network, port), serverNet));
+    }
+
+    std::vector<SoakClient> clients(static_cast<std::size_t>(options.soakClients));
+    for (std::size_t c = 0; c < clients.size(); ++c)
+    {
+        unsigned short port = static_cast<unsigned short>(options.port + shardCount + c);
+        NetConditions clientNet = options.net;
+        clientNet.seed += 1000 + static_cast<std::uint32_t>(c);
+        clients[c].transport = applyConditions(std::make_unique<LoopbackTransport>(network, port), clientNet);
+        clients[c].matchId = static_cast<std::uint32_t>(c);
+    }
+
+    std::cout << "Soak test: " << clients.size() << " clients, " << shardCount << " shards, latency "
+              << options.net.latencyMs << "+/-" << options.net.jitterMs << " ms, loss "
+              << options.net.lossPercent << "%, dup " << options.net.duplicatePercent
+              << "%, reorder " << options.net.reorderPercent << "%, seed " << options.net.seed << "\n";
+
+    for (auto &shard : shards)
+        shard->start(false);
+
+    sf::Clock clock;
+    sf::Time next = clock.getElapsedTime();
+    std::uint32_t clientTick = 0;
+    sf::Packet packet;
+
+    while (clock.getElapsedTime().asSeconds() < options.loadTestSeconds)
+    {
+        float serverTickEstimate = clock.getElapsedTime().asSeconds() / TickDt;
+
+        for (SoakClient &client : clients)
+        {
+            unsigned short shardPort = static_cast<unsigned short>(options.port + client.matchId % shardCount);
+
+            // Keep asking to join (echoing the nonce once challenged) until
+            // the first State proves it arrived
+            packet.clear();
+            if (client.states == 0)
+            {
+                packet << static_cast<std::uint8_t>(PacketType::Join) << client.matchId << client.nonce;
+            }
+            else
+            {
+                PlayerInput input;
+                input.right = (clientTick / 60) % 2 == 0;
+                input.left = !input.right;
+                packet << static_cast<std::uint8_t>(PacketType::Input) << client.matchId << clientTick
+                       << packButtons(input) << input.aim.x << input.aim.y;
+            }
+            client.transport->send(packet, sf::IpAddress::LocalHost, shardPort);
+
+            std::optional<sf::IpAddress> sender;
+            unsigned short senderPort = 0;
+            while (client.transport->receive(packet, sender, senderPort))
+            {
+                std::uint8_t type = 0;
+                std::uint32_t matchId = 0, tick = 0;
+                if (!(packet >> type >> matchId))
+                    continue;
+                if (type == static_cast<std::uint8_t>(PacketType::Challenge))
+                {
+                    packet >> client.nonce; // Echoed by the next Join
+                    continue;
+                }
+                if (type != static_cast<std::uint8_t>(PacketType::State) || !(packet >> tick))
+                    continue;
+
+                if (tick < client.seenTicks.size() && client.seenTicks[tick])
+                {
+                    ++client.duplicates;
+                }
+                else
+                {
+                    if (tick >= client.seenTicks.size())
+                        client.seenTicks.resize(tick + 1);
+                    client.seenTicks[tick] = true;
+                    if (client.states > 0 && tick < client.lastTick)
+                        ++client.outOfOrder;
+                    else
+                        client.lastTick = tick;
+                }
+
+                ++client.states;
+                client.lagTicks += std::max(0.0f, serverTickEstimate - static_cast<float>(tick));
+            }
+        }
+        ++clientTick;
+
+        next += sf::seconds(TickDt);
+        sf::Time now = clock.getElapsedTime();
+        if (next > now)
+            sf::sleep(next - now);
+    }
+
+    for (auto &shard : shards)
+        shard->stop();
+
+    for (std::size_t c = 0; c < clients.size(); ++c)
+    {
+        // Its match sends one State per tick from the join on; count those up
+        // to the newest one received, as later ones may still be in flight
+        const SoakClient &client = clients[c];
+        const Match *match = shards[client.matchId % shardCount]->findMatch(client.matchId);
+        std::optional<std::uint32_t> firstTick = match ? match->getFirstStateTick() : std::nullopt;
+        double sentByServer = client.states > 0 && firstTick && client.lastTick >= *firstTick
+                                  ? static_cast<double>(client.lastTick - *firstTick + 1)
+                                  : 0.0;
+        double unique = static_cast<double>(client.states - client.duplicates);
+        std::cout << "  client " << c << ": " << client.states << " states, "
+                  << (sentByServer > 0 ? 100.0 * (1.0 - unique / sentByServer) : 0.0)
+                  << "% missing, " << client.duplicates << " dup, " << client.outOfOrder
+                  << " out of order, mean age "
+                  << (client.states ? client.lagTicks / client.states * TickDt * 1000.0 : 0.0) << " ms\n";
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <SFML/Network/IpAddress.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "InterestManager.h"
+#include "NetTransport.h"
+#include "Options.h"
+#include "World.h"
+
+// One independent match: its own World, its own clients and relevance state.
+// Nothing is shared between matches, so a shard can step them in any order.
+class Match
+{
+private:
+    struct Client
+    {
+        sf::IpAddress address;
+        unsigned short port;
+        std::uint32_t interestId;
+        std::uint32_t lastHeard; // Tick of its latest Join or Input
+    };
+
+    std::uint32_t matchId;
+    World world;
+    PlayerInput input;
+    InterestManager interest;
+    std::vector<Client> clients;
+    std::vector<ReplicatedEntity> replicated;
+    std::uint32_t tick;
+    std::optional<std::uint32_t> firstStateTick; // Tick of the first State sent to any client
+
+    void gatherReplicated();
+    Client *findClient(const sf::IpAddress &address, unsigned short port);
+
+public:
+    Match(std::uint32_t id, std::shared_ptr<const Level> level);
+
+    // Only for senders that completed the join handshake. Ignored when the
+    // match is full; a repeated Join just keeps the client alive.
+    void addClient(const sf::IpAddress &address, unsigned short port);
+    // Input from anyone but a joined client is dropped
+    void setInput(const sf::IpAddress &address, unsigned short port, const PlayerInput &newInput);
+    void useBotInput();
+    void step(float dt);
+    void replicate(Transport &transport);
+
+    std::uint32_t getId() const { return matchId; }
+    std::uint32_t getTick() const { return tick; }
+    std::optional<std::uint32_t> getFirstStateTick() const { return firstStateTick; }
+};
+
+// A worker thread pinned to one core that owns a set of matches and, in
+// server mode, one transport (a UDP socket, possibly behind a network
+// simulator). Incoming packets are demultiplexed by match id.
+class ServerShard
+{
+private:
+    unsigned int index;
+    std::vector<std::unique_ptr<Match>> matches;
+    std::unordered_map<std::uint32_t, Match *> matchById;
+    std::unique_ptr<Transport> transport;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> ticks;
+    std::uint64_t joinSecret; // Keys the join nonces; random per shard
+
+    void receivePackets();
+    void runServer();
+    void runLoadTest();
+
+public:
+    explicit ServerShard(unsigned int shardIndex);
+    ~ServerShard();
+
+    void addMatch(std::uint32_t matchId, const std::shared_ptr<const Level> &level);
+    bool bind(unsigned short port, const NetConditions &conditions);
+    void setTransport(std::unique_ptr<Transport> newTransport) { transport = std::move(newTransport); }
+    void start(bool loadTest);
+    void stop();
+
+    unsigned int getIndex() const { return index; }
+    std::size_t getMatchCount() const { return matches.size(); }
+    // Only safe to inspect once stopped
+    const Match *findMatch(std::uint32_t matchId) const;
+    std::uint64_t getTicks() const { return ticks.load(std::memory_order_relaxed); }
+};
+
+// Headless entry points selected from main() by the command line
+int runLoadTest(const GameOptions &options);
+int runServer(const GameOptions &options);
+int runSoakTest(const GameOptions &options);
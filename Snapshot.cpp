@@ -0,0 +1,78 @@
+#include "Snapshot.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// ============= WorldSnapshot Implementation =============
+
+std::size_t WorldSnapshot::sizeFor(const SnapshotHeader &header)
+{
+    return sizeof(SnapshotHeader) + sizeof(PlayerRecord) +
+           std::size_t(header.enemyCount) * sizeof(EnemyRecord) +
+           std::size_t(header.projectileCount) * sizeof(ProjectileRecord) +
+           std::size_t(header.destructibleCount) * sizeof(DestructibleRecord);
+}
+
+void WorldSnapshot::begin(const SnapshotHeader &header)
+{
+    data.resize(sizeFor(header)); // No-op on capacity once warmed up
+    std::memcpy(data.data(), &header, sizeof(header));
+}
+
+bool WorldSnapshot::isValid() const
+{
+    if (data.size() < sizeof(SnapshotHeader) + sizeof(PlayerRecord))
+        return false;
+
+    const SnapshotHeader &header = getHeader();
+    return std::memcmp(header.magic, SnapshotFormat::Magic, sizeof(header.magic)) == 0 &&
+           header.version == SnapshotFormat::Version &&
+           header.byteOrder == SnapshotFormat::ByteOrderMark &&
+           data.size() == sizeFor(header);
+}
+
+bool WorldSnapshot::loadFromFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        std::cerr << "Cannot open snapshot " << path << "\n";
+        return false;
+    }
+
+    data.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file || !isValid())
+    {
+        std::cerr << path << ": not a snapshot, or written by another version\n";
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+bool WorldSnapshot::writeFile(const std::string &path) const
+{
+    // Same write-then-rename as levels, so a crash never leaves half a save
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            std::cerr << "Cannot write snapshot " << path << "\n";
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+    {
+        std::cerr << "Cannot write snapshot " << path << ": " << error.message() << "\n";
+        return false;
+    }
+    return true;
+}
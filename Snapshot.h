@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SnapshotFormat.h"
+
+// One captured world state (see SnapshotFormat.h). The buffer keeps its
+// capacity between captures, so a rollback/rewind ring of snapshots stops
+// allocating once it has warmed up.
+class WorldSnapshot
+{
+private:
+    std::vector<std::uint8_t> data;
+
+    template <typename T>
+    T *at(std::size_t offset) { return reinterpret_cast<T *>(data.data() + offset); }
+    template <typename T>
+    const T *at(std::size_t offset) const { return reinterpret_cast<const T *>(data.data() + offset); }
+
+    std::size_t enemiesOffset() const { return sizeof(SnapshotHeader) + sizeof(PlayerRecord); }
+    std::size_t projectilesOffset() const { return enemiesOffset() + getHeader().enemyCount * sizeof(EnemyRecord); }
+    std::size_t destructiblesOffset() const { return projectilesOffset() + getHeader().projectileCount * sizeof(ProjectileRecord); }
+
+public:
+    static std::size_t sizeFor(const SnapshotHeader &header);
+
+    // Sizes the buffer for the counts in 'header' and stores it; the records
+    // are then filled through the accessors below
+    void begin(const SnapshotHeader &header);
+
+    // Checks magic, version, byte order and that every record is in bounds
+    bool isValid() const;
+
+    bool loadFromFile(const std::string &path);
+    bool writeFile(const std::string &path) const;
+
+    const SnapshotHeader &getHeader() const { return *at<SnapshotHeader>(0); }
+    PlayerRecord &getPlayer() { return *at<PlayerRecord>(sizeof(SnapshotHeader)); }
+    const PlayerRecord &getPlayer() const { return *at<PlayerRecord>(sizeof(SnapshotHeader)); }
+    EnemyRecord *getEnemies() { return at<EnemyRecord>(enemiesOffset()); }
+    const EnemyRecord *getEnemies() const { return at<EnemyRecord>(enemiesOffset()); }
+    ProjectileRecord *getProjectiles() { return at<ProjectileRecord>(projectilesOffset()); }
+    const ProjectileRecord *getProjectiles() const { return at<ProjectileRecord>(projectilesOffset()); }
+    DestructibleRecord *getDestructibles() { return at<DestructibleRecord>(destructiblesOffset()); }
+    const DestructibleRecord *getDestructibles() const { return at<DestructibleRecord>(destructiblesOffset()); }
+
+    // Raw access for delta encoders; resize() keeps capacity and zero-fills growth
+    void resize(std::size_t size) { data.resize(size); }
+    std::uint8_t *getData() { return data.data(); }
+    const std::uint8_t *getData() const { return data.data(); }
+    std::size_t getSize() const { return data.size(); }
+    bool isEmpty() const { return data.empty(); }
+};
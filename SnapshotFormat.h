@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// Binary world snapshot. Records are plain old data written in place, so
+// capturing or restoring a world is one pass over each object list with no
+// per-field encoding:
+//
+//   SnapshotHeader
+//   PlayerRecord
+//   EnemyRecord[enemyCount]
+//   ProjectileRecord[projectileCount]
+//   DestructibleRecord[destructibleCount]
+//
+// Walls are not stored; they come from the level, which the header
+// identifies by hash and wall count. Host byte order, like level files.
+namespace SnapshotFormat
+{
+constexpr char Magic[4] = {'S', 'S', 'N', 'P'};
+constexpr std::uint32_t Version = 1;
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+} // namespace SnapshotFormat
+
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t tick;
+    std::uint32_t nextId;
+    std::uint32_t wallCount;
+    std::uint64_t levelHash; // Level::getSourceHash(), 0 for builtin/uncompiled levels
+    std::uint32_t enemyCount;
+    std::uint32_t projectileCount;
+    std::uint32_t destructibleCount;
+    std::uint32_t reserved;
+};
+
+struct ObjectRecord
+{
+    std::uint32_t id;
+    std::uint32_t active;
+    float x, y, w, h;
+};
+
+struct EntityRecord
+{
+    ObjectRecord object;
+    float vx, vy;
+    float speed;
+    std::uint32_t color; // sf::Color::toInteger()
+};
+
+struct PlayerRecord
+{
+    EntityRecord entity;
+    float health;
+    float shootCooldown;
+    float cooldownTimer;
+    std::uint32_t canShoot;
+};
+
+struct EnemyRecord
+{
+    EntityRecord entity;
+    float detectionRange;
+};
+
+struct ProjectileRecord
+{
+    ObjectRecord object;
+    float vx, vy;
+    float speed;
+    std::uint32_t color;
+    float lifetime;
+    float age;
+};
+
+struct DestructibleRecord
+{
+    ObjectRecord object;
+    std::uint32_t color;
+    float health;
+    float maxHealth;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48);
+static_assert(std::is_trivially_copyable_v<PlayerRecord> && sizeof(PlayerRecord) == 56);
+static_assert(std::is_trivially_copyable_v<EnemyRecord> && sizeof(EnemyRecord) == 44);
+static_assert(std::is_trivially_copyable_v<ProjectileRecord> && sizeof(ProjectileRecord) == 48);
+static_assert(std::is_trivially_copyable_v<DestructibleRecord> && sizeof(DestructibleRecord) == 36);
@@ -0,0 +1,61 @@
+#include "SpatialGrid.h"
+#include <cmath>
+
+// ============= SpatialGrid Implementation =============
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize) {}
+
+std::int64_t SpatialGrid::cellKey(int cx, int cy) const
+{
+    return (static_cast<std::int64_t>(cx) << 32) ^ static_cast<std::uint32_t>(cy);
+}
+
+int SpatialGrid::cellCoord(float v) const
+{
+    return static_cast<int>(std::floor(v / cellSize));
+}
+
+void SpatialGrid::clear()
+{
+    // Keep the buckets and their capacity; only drop the contents, and the
+    // buckets nothing has landed in for a while
+    for (auto it = cells.begin(); it != cells.end();)
+    {
+        Cell &cell = it->second;
+        if (!cell.ids.empty())
+        {
+            cell.ids.clear();
+            cell.idleClears = 0;
+        }
+        else if (++cell.idleClears >= IdleClearsBeforeErase)
+        {
+            it = cells.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void SpatialGrid::insert(std::uint32_t id, const sf::Vector2<float> &pos)
+{
+    cells[cellKey(cellCoord(pos.x), cellCoord(pos.y))].ids.push_back(id);
+}
+
+void SpatialGrid::queryCircle(const sf::Vector2<float> &center, float radius,
+                              std::vector<std::uint32_t> &out) const
+{
+    int minX = cellCoord(center.x - radius);
+    int maxX = cellCoord(center.x + radius);
+    int minY = cellCoord(center.y - radius);
+    int maxY = cellCoord(center.y + radius);
+
+    for (int cy = minY; cy <= maxY; ++cy)
+    {
+        for (int cx = minX; cx <= maxX; ++cx)
+        {
+            auto it = cells.find(cellKey(cx, cy));
+            if (it != cells.end())
+                out.insert(out.end(), it->second.ids.begin(), it->second.ids.end());
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform hashed grid over point positions. Cells are keyed by their integer
+// coordinates so the world does not need fixed bounds. Rebuilding keeps the
+// per-cell vectors alive, so steady-state ticks do not allocate; a cell left
+// empty for IdleClearsBeforeErase rebuilds is dropped, so the map follows
+// where entities are instead of growing with everywhere they have been.
+class SpatialGrid
+{
+private:
+    static constexpr std::uint32_t IdleClearsBeforeErase = 64;
+
+    struct Cell
+    {
+        std::vector<std::uint32_t> ids;
+        std::uint32_t idleClears = 0; // Rebuilds in a row that left it empty
+    };
+
+    float cellSize;
+    std::unordered_map<std::int64_t, Cell> cells;
+
+    std::int64_t cellKey(int cx, int cy) const;
+    int cellCoord(float v) const;
+
+public:
+    explicit SpatialGrid(float cellSize);
+
+    void clear();
+    void insert(std::uint32_t id, const sf::Vector2<float> &pos);
+
+    // Appends every id stored in a cell overlapping the circle. Callers still
+    // need an exact distance test; this only bounds the candidate set.
+    void queryCircle(const sf::Vector2<float> &center, float radius,
+                     std::vector<std::uint32_t> &out) const;
+
+    float getCellSize() const { return cellSize; }
+};
@@ -0,0 +1,73 @@
+#include "SpriteBatch.h"
+#include <SFML/Graphics/RenderStates.hpp>
+
+// ============= SpriteBatch Implementation =============
+
+SpriteBatch::SpriteBatch(const TextureAtlas &textures, sf::RenderTarget &renderTarget)
+    : atlas(textures), target(renderTarget), vertices(sf::PrimitiveType::Triangles), lastDrawCalls(0), lastQuads(0) {}
+
+void SpriteBatch::drawQuads(const DrawCommand &last)
+{
+    if (vertices.getVertexCount() == 0)
+        return;
+
+    sf::RenderStates states;
+    states.texture = last.getPage() < atlas.getPageCount() ? &atlas.getPage(last.getPage()) : nullptr;
+    states.blendMode = last.getBlend() == BlendMode::Add ? sf::BlendAdd : sf::BlendAlpha;
+    target.draw(vertices, states);
+    ++lastDrawCalls;
+    lastQuads += vertices.getVertexCount() / 6;
+    vertices.clear();
+}
+
+void SpriteBatch::drawDiscs()
+{
+    if (discs.getCount() == 0)
+        return;
+
+    lastQuads += discs.getCount();
+    discs.draw(target);
+    ++lastDrawCalls;
+}
+
+void SpriteBatch::submit(std::span<const DrawCommand> commands)
+{
+    lastDrawCalls = 0;
+    lastQuads = 0;
+    const DrawCommand *run = nullptr; // Last command in the pending quad run
+
+    for (const DrawCommand &command : commands)
+    {
+        const AtlasRegion &region = atlas.get(command.sprite);
+
+        // A tinted projectile is the builtin disc, which the shader draws
+        // without a texture
+        if (command.sprite == SpriteId::Projectile && region.tinted && discs.isAvailable())
+        {
+            if (run)
+                drawQuads(*run);
+            run = nullptr;
+            discs.add(command.rect, sf::Color(command.color));
+            continue;
+        }
+
+        drawDiscs();
+        if (run && run->getState() != command.getState())
+            drawQuads(*run);
+        run = &command;
+
+        sf::Color tint = region.tinted ? sf::Color(command.color) : sf::Color::White;
+        sf::Vector2<float> p0 = command.rect.position, p1 = command.rect.position + command.rect.size;
+        sf::Vector2<float> t0 = region.texRect.position, t1 = region.texRect.position + region.texRect.size;
+
+        vertices.append({p0, tint, t0});
+        vertices.append({{p1.x, p0.y}, tint, {t1.x, t0.y}});
+        vertices.append({{p0.x, p1.y}, tint, {t0.x, t1.y}});
+        vertices.append({{p0.x, p1.y}, tint, {t0.x, t1.y}});
+        vertices.append({{p1.x, p0.y}, tint, {t1.x, t0.y}});
+        vertices.append({p1, tint, t1});
+    }
+    if (run)
+        drawQuads(*run);
+    drawDiscs();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstddef>
+#include "ProjectileRenderer.h"
+#include "RenderQueue.h"
+#include "TextureAtlas.h"
+
+// SFML backend: turns a sorted command list into textured triangles, with
+// one draw call per run of commands sharing an atlas page and blend mode.
+// Projectiles without a sprite image go through the disc shader instead.
+class SpriteBatch : public RenderBackend
+{
+private:
+    const TextureAtlas &atlas;
+    sf::RenderTarget &target;
+    sf::VertexArray vertices; // Triangles; capacity survives clear()
+    ProjectileRenderer discs;
+    std::size_t lastDrawCalls;
+    std::size_t lastQuads;
+
+    void drawQuads(const DrawCommand &last);
+    void drawDiscs();
+
+public:
+    // 'textures' may still be empty; it is only read when submitting
+    SpriteBatch(const TextureAtlas &textures, sf::RenderTarget &renderTarget);
+
+    // Needs a GL context; without geometry shaders projectiles stay quads
+    bool enableDiscShader() { return discs.create(); }
+
+    void submit(std::span<const DrawCommand> commands) override;
+
+    std::size_t getLastDrawCalls() const { return lastDrawCalls; }
+    std::size_t getLastQuads() const { return lastQuads; }
+};
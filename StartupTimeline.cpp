@@ -0,0 +1,53 @@
+#include "StartupTimeline.h"
+#include <algorithm>
+#include <iomanip>
+
+// ============= StartupTimeline Implementation =============
+
+StartupTimeline::Scope::Scope(StartupTimeline &owner, const char *stepName, bool onWorker)
+    : timeline(owner), name(stepName), background(onWorker), startMs(owner.now()) {}
+
+StartupTimeline::Scope::~Scope()
+{
+    timeline.add(name, background, startMs, timeline.now());
+}
+
+void StartupTimeline::add(const std::string &name, bool background, float startMs, float endMs)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    spans.push_back({name, background, startMs, endMs});
+}
+
+void StartupTimeline::print(std::ostream &out) const
+{
+    constexpr int BarWidth = 40;
+
+    std::vector<Span> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = spans;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Span &a, const Span &b)
+                     { return a.startMs < b.startMs; });
+
+    float totalMs = 0;
+    for (const Span &span : sorted)
+        totalMs = std::max(totalMs, span.endMs);
+
+    out << "Startup timeline (" << std::fixed << std::setprecision(2) << totalMs << " ms)\n"
+        << "  thread   start ms     end ms  total ms  step\n";
+    for (const Span &span : sorted)
+    {
+        // Bar columns cover [start, end) of the whole timeline
+        int from = totalMs > 0 ? static_cast<int>(span.startMs / totalMs * BarWidth) : 0;
+        int to = totalMs > 0 ? static_cast<int>(span.endMs / totalMs * BarWidth) : 0;
+        to = std::clamp(std::max(to, from + 1), 1, BarWidth);
+        from = std::min(from, to - 1);
+
+        out << "  " << std::left << std::setw(7) << (span.background ? "worker" : "main") << std::right
+            << std::setw(9) << span.startMs << std::setw(11) << span.endMs << std::setw(10)
+            << span.endMs - span.startMs << "  |" << std::string(from, ' ') << std::string(to - from, '#')
+            << std::string(BarWidth - to, ' ') << "| " << span.name << "\n";
+    }
+    out.unsetf(std::ios::floatfield);
+}
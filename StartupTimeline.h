@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Wall-clock spans of the steps between launch and the first frame,
+// including the ones overlapped on worker threads. Safe to record into
+// from any thread.
+class StartupTimeline
+{
+private:
+    struct Span
+    {
+        std::string name;
+        bool background; // Ran on a worker, overlapping the main thread
+        float startMs;
+        float endMs;
+    };
+
+    sf::Clock clock;
+    mutable std::mutex mutex;
+    std::vector<Span> spans;
+
+public:
+    // Records a span from its construction to its destruction
+    class Scope
+    {
+    private:
+        StartupTimeline &timeline;
+        const char *name;
+        bool background;
+        float startMs;
+
+    public:
+        Scope(StartupTimeline &owner, const char *stepName, bool onWorker);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    float now() const { return clock.getElapsedTime().asSeconds() * 1000.0f; }
+
+    Scope measure(const char *name, bool background = false) { return Scope(*this, name, background); }
+    void add(const std::string &name, bool background, float startMs, float endMs);
+
+    // One row per span, in start order, with a bar scaled to the latest end
+    void print(std::ostream &out) const;
+};
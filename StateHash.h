@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a over the exact bit patterns of simulation state. Two worlds that
+// hash equal went through bit-identical updates, which is what lockstep
+// desync detection needs (an epsilon compare would hide drift).
+class StateHash
+{
+private:
+    std::uint64_t value;
+
+    void addBytes(const void *data, std::size_t size)
+    {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+
+public:
+    StateHash() : value(14695981039346656037ull) {}
+
+    void add(std::uint32_t v) { addBytes(&v, sizeof(v)); }
+    void add(bool v) { add(static_cast<std::uint32_t>(v)); }
+    void add(float v)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        add(bits);
+    }
+    void add(const sf::Vector2<float> &v)
+    {
+        add(v.x);
+        add(v.y);
+    }
+
+    std::uint64_t get() const { return value; }
+};
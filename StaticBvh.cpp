@@ -0,0 +1,121 @@
+#include "StaticBvh.h"
+#include <algorithm>
+
+namespace
+{
+constexpr std::uint32_t LeafSize = 4;
+
+bool overlaps(const BvhNode &node, const sf::Rect<float> &area)
+{
+    return node.minX < area.position.x + area.size.x && area.position.x < node.maxX &&
+           node.minY < area.position.y + area.size.y && area.position.y < node.maxY;
+}
+
+void fitBounds(BvhNode &node, const std::vector<LevelRect> &rects, const std::uint32_t *items, std::uint32_t count)
+{
+    node.minX = node.minY = 1e30f;
+    node.maxX = node.maxY = -1e30f;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        const LevelRect &r = rects[items[i]];
+        node.minX = std::min(node.minX, r.x);
+        node.minY = std::min(node.minY, r.y);
+        node.maxX = std::max(node.maxX, r.x + r.w);
+        node.maxY = std::max(node.maxY, r.y + r.h);
+    }
+}
+} // namespace
+
+// ============= StaticBvh Implementation =============
+
+StaticBvh::StaticBvh() : nodes(nullptr), nodeCount(0), items(nullptr), itemCount(0) {}
+
+StaticBvh::StaticBvh(const BvhNode *nodeData, std::uint32_t nodes, const std::uint32_t *itemData, std::uint32_t items)
+    : nodes(nodeData), nodeCount(nodes), items(itemData), itemCount(items) {}
+
+void StaticBvh::query(const sf::Rect<float> &area, std::vector<std::uint32_t> &out) const
+{
+    if (nodeCount == 0)
+        return;
+
+    // Holds the pending sibling of each level above plus two children
+    std::uint32_t stack[MaxDepth + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BvhNode &node = nodes[stack[--top]];
+        if (!overlaps(node, area))
+            continue;
+
+        if (node.count > 0)
+        {
+            out.insert(out.end(), items + node.first, items + node.first + node.count);
+        }
+        else
+        {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+}
+
+void StaticBvh::build(const std::vector<LevelRect> &rects,
+                      std::vector<BvhNode> &outNodes, std::vector<std::uint32_t> &outItems)
+{
+    outNodes.clear();
+    outItems.resize(rects.size());
+    for (std::uint32_t i = 0; i < rects.size(); ++i)
+        outItems[i] = i;
+    if (rects.empty())
+        return;
+
+    struct Task
+    {
+        std::uint32_t node, first, count;
+    };
+    std::vector<Task> tasks;
+
+    outNodes.push_back(BvhNode());
+    tasks.push_back({0, 0, static_cast<std::uint32_t>(rects.size())});
+
+    while (!tasks.empty())
+    {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        BvhNode &node = outNodes[task.node];
+        fitBounds(node, rects, outItems.data() + task.first, task.count);
+
+        if (task.count <= LeafSize)
+        {
+            node.first = task.first;
+            node.count = task.count;
+            continue;
+        }
+
+        // Median split on the longer axis of the node; keeps depth at log2(n)
+        bool splitX = (node.maxX - node.minX) >= (node.maxY - node.minY);
+        auto begin = outItems.begin() + task.first;
+        auto mid = begin + task.count / 2;
+        std::nth_element(begin, mid, begin + task.count,
+                         [&](std::uint32_t a, std::uint32_t b)
+                         {
+                             const LevelRect &ra = rects[a];
+                             const LevelRect &rb = rects[b];
+                             return splitX ? ra.x + ra.w * 0.5f < rb.x + rb.w * 0.5f
+                                           : ra.y + ra.h * 0.5f < rb.y + rb.h * 0.5f;
+                         });
+
+        std::uint32_t left = static_cast<std::uint32_t>(outNodes.size());
+        node.first = left;
+        node.count = 0;
+        outNodes.push_back(BvhNode()); // May reallocate: 'node' is not used below
+        outNodes.push_back(BvhNode());
+
+        std::uint32_t half = task.count / 2;
+        tasks.push_back({left, task.first, half});
+        tasks.push_back({left + 1, task.first + half, task.count - half});
+    }
+}
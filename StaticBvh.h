@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <vector>
+#include "LevelFormat.h"
+
+// Bounding volume hierarchy over static rectangles. Built once (offline by
+// the level writer), then queried through a non-owning view so the node and
+// item arrays can live directly in a mapped level file.
+class StaticBvh
+{
+private:
+    const BvhNode *nodes;
+    std::uint32_t nodeCount;
+    const std::uint32_t *items;
+    std::uint32_t itemCount;
+
+public:
+    // Deepest leaf a query can reach (the root is depth 0). Queries use a
+    // fixed stack of MaxDepth + 2 entries; build() stays far below this and
+    // Level::bind() rejects files that go deeper.
+    static constexpr std::uint32_t MaxDepth = 62;
+
+    StaticBvh();
+    StaticBvh(const BvhNode *nodeData, std::uint32_t nodes, const std::uint32_t *itemData, std::uint32_t items);
+
+    // Appends the indices of every rect that may overlap 'area' (whole leaves
+    // are returned, so callers still do the exact test)
+    void query(const sf::Rect<float> &area, std::vector<std::uint32_t> &out) const;
+
+    bool isEmpty() const { return nodeCount == 0; }
+    const BvhNode *getNodes() const { return nodes; }
+    std::uint32_t getNodeCount() const { return nodeCount; }
+    const std::uint32_t *getItems() const { return items; }
+
+    static void build(const std::vector<LevelRect> &rects,
+                      std::vector<BvhNode> &outNodes, std::vector<std::uint32_t> &outItems);
+};
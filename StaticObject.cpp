@@ -10,12 +10,9 @@ void StaticObject::update(float dt)
     // Static objects don't update their state over time
 }
 
-void StaticObject::render(sf::RenderWindow &window)
+void StaticObject::render(RenderQueue &queue) const
 {
-    sf::RectangleShape shape(size);
-    shape.setPosition(position);
-    shape.setFillColor(color);
-    window.draw(shape);
+    queue.draw(getSprite(), getBounds(), color, RenderLayer::Static);
 }
 
 // ============= Wall Implementation =============
@@ -29,6 +26,28 @@ DestructibleObject::DestructibleObject(float x, float y, float w, float h, float
     : StaticObject(x, y, w, h, sf::Color(139, 69, 19)),
       health(hp), maxHealth(hp) {}
 
+void DestructibleObject::hashState(StateHash &hash) const
+{
+    GameObject::hashState(hash);
+    hash.add(health);
+}
+
+void DestructibleObject::saveState(DestructibleRecord &record) const
+{
+    GameObject::saveState(record.object);
+    record.color = color.toInteger();
+    record.health = health;
+    record.maxHealth = maxHealth;
+}
+
+void DestructibleObject::loadState(const DestructibleRecord &record)
+{
+    GameObject::loadState(record.object);
+    color = sf::Color(record.color);
+    health = record.health;
+    maxHealth = record.maxHealth;
+}
+
 void DestructibleObject::takeDamage(float damage)
 {
     health -= damage;
@@ -40,7 +59,7 @@ void DestructibleObject::takeDamage(float damage)
 
     // Change color based on health
     float ratio = health / maxHealth;
-    color = sf::Color(static_cast<sf::Uint8>(139 * ratio),
-                      static_cast<sf::Uint8>(69 * ratio),
-                      static_cast<sf::Uint8>(19 * ratio));
+    color = sf::Color(static_cast<std::uint8_t>(139 * ratio),
+                      static_cast<std::uint8_t>(69 * ratio),
+                      static_cast<std::uint8_t>(19 * ratio));
 }
\ No newline at end of file
@@ -13,7 +13,8 @@ public:
     virtual ~StaticObject() override {}
 
     void update(float dt) override;
-    void render(sf::RenderWindow &window) override;
+    void render(RenderQueue &queue) const override;
+    sf::Color getColor() const { return color; }
 };
 
 // Wall obstacle
@@ -22,6 +23,8 @@ class Wall : public StaticObject
 public:
     Wall(float x, float y, float w, float h);
     virtual ~Wall() override {}
+
+    SpriteId getSprite() const override { return SpriteId::Wall; }
 };
 
 // Destructible object
@@ -36,5 +39,9 @@ public:
     virtual ~DestructibleObject() override {}
 
     void takeDamage(float damage);
+    void hashState(StateHash &hash) const override;
+    SpriteId getSprite() const override { return SpriteId::Destructible; }
+    void saveState(DestructibleRecord &record) const;
+    void loadState(const DestructibleRecord &record);
     float getHealth() const { return health; }
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "StaticTileCache.h"
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <cmath>
+#include "SpriteBatch.h"
+
+namespace
+{
+std::int32_t tileOf(float v) { return static_cast<std::int32_t>(std::floor(v / StaticTileCache::TileSize)); }
+
+sf::Rect<float> tileBounds(std::int32_t x, std::int32_t y)
+{
+    constexpr auto size = static_cast<float>(StaticTileCache::TileSize);
+    return {{static_cast<float>(x) * size, static_cast<float>(y) * size}, {size, size}};
+}
+} // namespace
+
+// ============= StaticTileCache Implementation =============
+
+StaticTileCache::StaticTileCache(const TextureAtlas &textures)
+    : atlas(textures), queue(textures), generation(0), frame(0), failed(false), lastRedraws(0)
+{
+    tiles.reserve(MaxTiles);
+}
+
+StaticTileCache::Tile *StaticTileCache::acquire(std::int32_t x, std::int32_t y)
+{
+    Tile *oldest = nullptr;
+    for (Tile &tile : tiles)
+    {
+        if (tile.x == x && tile.y == y)
+            return &tile;
+        if (tile.lastDrawn != frame && (!oldest || tile.lastDrawn < oldest->lastDrawn))
+            oldest = &tile;
+    }
+
+    if (tiles.size() < MaxTiles)
+    {
+        tiles.push_back({sf::RenderTexture(), x, y, frame, true});
+        if (!tiles.back().texture.resize({TileSize, TileSize}))
+        {
+            tiles.pop_back();
+            return nullptr;
+        }
+        return &tiles.back();
+    }
+    if (!oldest)
+        return nullptr; // Every tile is in use this frame
+    oldest->x = x;
+    oldest->y = y;
+    oldest->dirty = true;
+    return oldest;
+}
+
+void StaticTileCache::redraw(Tile &tile, const World &world)
+{
+    sf::Rect<float> bounds = tileBounds(tile.x, tile.y);
+    tile.texture.setView(sf::View(bounds));
+    tile.texture.clear(sf::Color::Transparent);
+
+    // Alpha blending into a transparent target leaves the colour
+    // premultiplied, which the composite in draw() accounts for
+    SpriteBatch batch(atlas, tile.texture);
+    world.renderWalls(queue, bounds);
+    queue.flush(batch);
+    tile.texture.display();
+    tile.dirty = false;
+    ++lastRedraws;
+}
+
+void StaticTileCache::invalidate(std::span<const sf::Rect<float>> areas)
+{
+    for (const sf::Rect<float> &area : areas)
+        for (Tile &tile : tiles)
+            if (!tile.dirty && area.findIntersection(tileBounds(tile.x, tile.y)))
+                tile.dirty = true;
+}
+
+bool StaticTileCache::draw(sf::RenderTarget &target, const World &world, const sf::Rect<float> &visible)
+{
+    lastRedraws = 0;
+    if (failed)
+        return false;
+
+    ++frame;
+    if (world.getStaticGeneration() != generation)
+    {
+        generation = world.getStaticGeneration();
+        for (Tile &tile : tiles)
+            tile.dirty = true;
+    }
+
+    std::int32_t x0 = tileOf(visible.position.x), x1 = tileOf(visible.position.x + visible.size.x);
+    std::int32_t y0 = tileOf(visible.position.y), y1 = tileOf(visible.position.y + visible.size.y);
+    if (static_cast<std::size_t>(x1 - x0 + 1) * static_cast<std::size_t>(y1 - y0 + 1) > MaxTiles)
+        return false; // A window this large draws directly
+
+    // Bring every tile up to date first: redrawing switches the GL target
+    for (std::int32_t y = y0; y <= y1; ++y)
+    {
+        for (std::int32_t x = x0; x <= x1; ++x)
+        {
+            Tile *tile = acquire(x, y);
+            if (!tile)
+            {
+                failed = true;
+                return false;
+            }
+            tile->lastDrawn = frame;
+            if (tile->dirty)
+                redraw(*tile, world);
+        }
+    }
+
+    sf::RenderStates states(sf::BlendMode(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha));
+    constexpr auto size = static_cast<float>(TileSize);
+    for (const Tile &tile : tiles)
+    {
+        if (tile.lastDrawn != frame)
+            continue;
+        sf::Vector2<float> p0 = tileBounds(tile.x, tile.y).position, p1 = p0 + sf::Vector2<float>(size, size);
+        const sf::Vertex quad[] = {{p0, sf::Color::White, {0, 0}},
+                                   {{p1.x, p0.y}, sf::Color::White, {size, 0}},
+                                   {{p0.x, p1.y}, sf::Color::White, {0, size}},
+                                   {p1, sf::Color::White, {size, size}}};
+        states.texture = &tile.texture.getTexture();
+        target.draw(quad, 4, sf::PrimitiveType::TriangleStrip, states);
+    }
+    return true;
+}
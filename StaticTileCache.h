@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "RenderQueue.h"
+#include "TextureAtlas.h"
+#include "World.h"
+
+// Walls pre-rendered into square tiles on a fixed world grid. A frame draws
+// the few tiles overlapping the view, one textured quad each, instead of
+// every wall. Destructibles change too often to cache this way; see
+// DestructibleBuffer. Tiles are only redrawn after the
+// world reports a change overlapping them; the least recently drawn one is
+// reused when the pool is full.
+class StaticTileCache
+{
+public:
+    // World units per tile side, drawn 1:1 (the camera does not zoom).
+    // A streaming chunk is 2x2 tiles.
+    static constexpr std::int32_t TileSize = 512;
+    // 1 MiB each; enough for a 4K window
+    static constexpr std::size_t MaxTiles = 64;
+
+private:
+    struct Tile
+    {
+        sf::RenderTexture texture;
+        std::int32_t x, y; // Grid coordinates: floor(position / TileSize)
+        std::uint64_t lastDrawn; // Frame number
+        bool dirty;
+    };
+
+    const TextureAtlas &atlas;
+    std::vector<Tile> tiles;
+    RenderQueue queue; // Scratch for redraws
+    std::uint32_t generation;
+    std::uint64_t frame;
+    bool failed; // No render textures on this GL; callers draw directly
+    std::size_t lastRedraws;
+
+    Tile *acquire(std::int32_t x, std::int32_t y);
+    void redraw(Tile &tile, const World &world);
+
+public:
+    explicit StaticTileCache(const TextureAtlas &textures);
+
+    // Marks the tiles overlapping each area for a redraw
+    void invalidate(std::span<const sf::Rect<float>> areas);
+
+    // Draws the walls for 'visible' into 'target', whose view must already
+    // be set. Returns false without drawing if the tiles cannot be used, in
+    // which case the caller draws World::renderWalls() itself.
+    bool draw(sf::RenderTarget &target, const World &world, const sf::Rect<float> &visible);
+
+    std::size_t getLastRedraws() const { return lastRedraws; }
+};
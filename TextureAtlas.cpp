@@ -0,0 +1,241 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+constexpr int Padding = 1; // Edge texels are repeated into it so filtering never bleeds
+
+struct PackItem
+{
+    SpriteId id;
+    sf::Image image;
+    std::uint32_t page;
+    sf::Vector2<int> position; // Of the padded block
+};
+
+sf::Image makeDisc(unsigned int diameter)
+{
+    sf::Image disc({diameter, diameter}, sf::Color::Transparent);
+    float radius = diameter * 0.5f;
+    for (unsigned int y = 0; y < diameter; ++y)
+    {
+        for (unsigned int x = 0; x < diameter; ++x)
+        {
+            float dx = x + 0.5f - radius, dy = y + 0.5f - radius;
+            float coverage = std::clamp(radius - std::sqrt(dx * dx + dy * dy) + 0.5f, 0.0f, 1.0f);
+            disc.setPixel({x, y}, sf::Color(255, 255, 255, static_cast<std::uint8_t>(coverage * 255)));
+        }
+    }
+    return disc;
+}
+
+// Copies 'image' into 'page' at 'position' + Padding and extrudes its border
+void blit(sf::Image &page, const sf::Image &image, sf::Vector2<int> position)
+{
+    sf::Vector2u size = image.getSize();
+    for (int y = -Padding; y < static_cast<int>(size.y) + Padding; ++y)
+    {
+        for (int x = -Padding; x < static_cast<int>(size.x) + Padding; ++x)
+        {
+            unsigned int sx = static_cast<unsigned int>(std::clamp(x, 0, static_cast<int>(size.x) - 1));
+            unsigned int sy = static_cast<unsigned int>(std::clamp(y, 0, static_cast<int>(size.y) - 1));
+            page.setPixel({static_cast<unsigned int>(position.x + Padding + x), static_cast<unsigned int>(position.y + Padding + y)},
+                          image.getPixel({sx, sy}));
+        }
+    }
+}
+} // namespace
+
+// ============= SkylinePacker Implementation =============
+
+SkylinePacker::SkylinePacker(int pageWidth, int pageHeight)
+    : width(pageWidth), height(pageHeight), skyline{{0, 0, pageWidth}} {}
+
+bool SkylinePacker::fits(std::size_t index, int w, int h, int &y) const
+{
+    int x = skyline[index].x;
+    if (x + w > width)
+        return false;
+
+    // The block rests on the highest segment it spans
+    y = 0;
+    int remaining = w;
+    for (std::size_t i = index; remaining > 0; ++i)
+    {
+        if (i == skyline.size())
+            return false;
+        y = std::max(y, skyline[i].y);
+        if (y + h > height)
+            return false;
+        remaining -= skyline[i].width;
+    }
+    return true;
+}
+
+bool SkylinePacker::insert(int w, int h, sf::Vector2<int> &position)
+{
+    // Bottom-left rule: lowest resulting top edge, ties to the narrower gap
+    std::size_t best = skyline.size();
+    int bestTop = height + 1, bestWidth = width + 1, bestY = 0;
+    for (std::size_t i = 0; i < skyline.size(); ++i)
+    {
+        int y = 0;
+        if (fits(i, w, h, y) && (y + h < bestTop || (y + h == bestTop && skyline[i].width < bestWidth)))
+        {
+            best = i;
+            bestTop = y + h;
+            bestWidth = skyline[i].width;
+            bestY = y;
+        }
+    }
+    if (best == skyline.size())
+        return false;
+
+    position = {skyline[best].x, bestY};
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best), {position.x, bestY + h, w});
+
+    // Trim or drop the segments now covered by the new one
+    for (std::size_t i = best + 1; i < skyline.size();)
+    {
+        int coveredTo = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= coveredTo)
+            break;
+        int shrink = coveredTo - skyline[i].x;
+        if (skyline[i].width > shrink)
+        {
+            skyline[i].x += shrink;
+            skyline[i].width -= shrink;
+            break;
+        }
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Merge neighbours at the same height
+    for (std::size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return true;
+}
+
+int SkylinePacker::getUsedHeight() const
+{
+    int top = 0;
+    for (const Segment &segment : skyline)
+        top = std::max(top, segment.y);
+    return top;
+}
+
+// ============= TextureAtlas Implementation =============
+
+TextureAtlas::TextureAtlas()
+{
+    for (AtlasRegion &region : regions)
+        region = {0, {}, true};
+}
+
+const char *TextureAtlas::spriteName(SpriteId id)
+{
+    static const char *const names[] = {"flat", "disc", "player", "enemy", "projectile", "wall", "destructible"};
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(SpriteId::Count));
+    return names[static_cast<std::size_t>(id)];
+}
+
+AtlasLayout TextureAtlas::pack(const StreamOpener &open, unsigned int pageSize)
+{
+    AtlasLayout layout;
+    std::vector<PackItem> items;
+    items.push_back({SpriteId::Flat, sf::Image({4, 4}, sf::Color::White), 0, {}});
+    items.push_back({SpriteId::Disc, makeDisc(32), 0, {}});
+
+    for (std::size_t i = static_cast<std::size_t>(SpriteId::Player); i < static_cast<std::size_t>(SpriteId::Count); ++i)
+    {
+        auto id = static_cast<SpriteId>(i);
+        std::string name = std::string("sprites/") + spriteName(id) + ".png";
+        std::unique_ptr<sf::InputStream> stream = open(name);
+        sf::Image image;
+        if (!stream || !image.loadFromStream(*stream))
+            continue; // Drawn with the flat/disc fallback
+        sf::Vector2u size = image.getSize();
+        if (size.x + 2 * Padding > pageSize || size.y + 2 * Padding > pageSize)
+        {
+            std::cerr << name << " is larger than an atlas page, skipped\n";
+            continue;
+        }
+        items.push_back({id, std::move(image), 0, {}});
+    }
+
+    // Tallest first packs a skyline tightest
+    std::stable_sort(items.begin(), items.end(), [](const PackItem &a, const PackItem &b)
+                     { return a.image.getSize().y > b.image.getSize().y; });
+
+    std::vector<SkylinePacker> packers;
+    for (PackItem &item : items)
+    {
+        int w = static_cast<int>(item.image.getSize().x) + 2 * Padding;
+        int h = static_cast<int>(item.image.getSize().y) + 2 * Padding;
+        std::size_t page = 0;
+        while (page < packers.size() && !packers[page].insert(w, h, item.position))
+            ++page;
+        if (page == packers.size())
+        {
+            packers.emplace_back(static_cast<int>(pageSize), static_cast<int>(pageSize));
+            packers.back().insert(w, h, item.position);
+        }
+        item.page = static_cast<std::uint32_t>(page);
+    }
+
+    // Pages are only as tall as their skyline needs, to save texture memory
+    for (const SkylinePacker &packer : packers)
+        layout.pages.emplace_back(sf::Vector2u(pageSize, static_cast<unsigned int>(packer.getUsedHeight())), sf::Color::Transparent);
+    for (const PackItem &item : items)
+    {
+        blit(layout.pages[item.page], item.image, item.position);
+
+        sf::Vector2<float> origin(static_cast<float>(item.position.x + Padding), static_cast<float>(item.position.y + Padding));
+        sf::Vector2<float> size(static_cast<float>(item.image.getSize().x), static_cast<float>(item.image.getSize().y));
+        AtlasRegion &region = layout.regions[static_cast<std::size_t>(item.id)];
+        region.page = item.page;
+        region.tinted = item.id == SpriteId::Flat || item.id == SpriteId::Disc;
+        // Flat quads sample one point in the middle of the white block
+        region.texRect = item.id == SpriteId::Flat ? sf::Rect<float>(origin + size * 0.5f, {0, 0})
+                                                   : sf::Rect<float>(origin, size);
+    }
+
+    // Sprites without an image reuse a fallback region
+    for (std::size_t i = static_cast<std::size_t>(SpriteId::Player); i < static_cast<std::size_t>(SpriteId::Count); ++i)
+    {
+        bool loaded = std::any_of(items.begin(), items.end(), [&](const PackItem &item)
+                                  { return item.id == static_cast<SpriteId>(i); });
+        if (!loaded)
+            layout.regions[i] = layout.regions[static_cast<std::size_t>(
+                static_cast<SpriteId>(i) == SpriteId::Projectile ? SpriteId::Disc : SpriteId::Flat)];
+    }
+    return layout;
+}
+
+bool TextureAtlas::upload(const AtlasLayout &layout)
+{
+    std::copy(std::begin(layout.regions), std::end(layout.regions), regions);
+    pages.resize(layout.pages.size());
+    for (std::size_t i = 0; i < layout.pages.size(); ++i)
+    {
+        if (!pages[i].loadFromImage(layout.pages[i]))
+        {
+            std::cerr << "Cannot create atlas page " << i << "\n";
+            return false;
+        }
+    }
+    return true;
+}
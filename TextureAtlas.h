@@ -0,0 +1,90 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/InputStream.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every visual the game draws. Sprites without an image fall back to Flat
+// (a white texel, tinted with the object's colour) or Disc.
+enum class SpriteId : std::uint8_t
+{
+    Flat,
+    Disc,
+    Player,
+    Enemy,
+    Projectile,
+    Wall,
+    Destructible,
+    Count
+};
+
+struct AtlasRegion
+{
+    std::uint32_t page;
+    sf::Rect<float> texRect; // In texels, as sf::Vertex::texCoords expects
+    bool tinted;             // Flat/Disc fallbacks take the object's colour
+};
+
+// Skyline bin packer for one page: rectangles are placed at the lowest
+// position along a "skyline" of placed tops, which suits sprites sorted by
+// height and wastes little space for game-sized images.
+class SkylinePacker
+{
+private:
+    struct Segment
+    {
+        int x, y, width;
+    };
+
+    int width, height;
+    std::vector<Segment> skyline;
+
+    bool fits(std::size_t index, int w, int h, int &y) const;
+
+public:
+    SkylinePacker(int pageWidth, int pageHeight);
+    bool insert(int w, int h, sf::Vector2<int> &position);
+    int getUsedHeight() const;
+};
+
+// Packed page images and where each sprite landed; CPU-only, so it can be
+// built on any thread
+struct AtlasLayout
+{
+    std::vector<sf::Image> pages;
+    AtlasRegion regions[static_cast<std::size_t>(SpriteId::Count)];
+};
+
+// Sprite images packed into as few texture pages as possible, so a whole
+// frame of sprites can be drawn with one texture bind per page.
+class TextureAtlas
+{
+private:
+    std::vector<sf::Texture> pages;
+    AtlasRegion regions[static_cast<std::size_t>(SpriteId::Count)];
+
+public:
+    using StreamOpener = std::function<std::unique_ptr<sf::InputStream>(const std::string &)>;
+
+    TextureAtlas();
+
+    // Loads sprites/<name>.png for each SpriteId through 'open' (missing
+    // images fall back) and packs them with the builtin white and disc
+    // texels. Needs no GL context.
+    static AtlasLayout pack(const StreamOpener &open, unsigned int pageSize = 2048);
+
+    // Creates the page textures; needs a GL context
+    bool upload(const AtlasLayout &layout);
+
+    const AtlasRegion &get(SpriteId id) const { return regions[static_cast<std::size_t>(id)]; }
+    const sf::Texture &getPage(std::uint32_t page) const { return pages[page]; }
+    std::size_t getPageCount() const { return pages.size(); }
+
+    static const char *spriteName(SpriteId id);
+};
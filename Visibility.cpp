@@ -0,0 +1,413 @@
+#include "Visibility.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace
+{
+// Orders directions like atan2 (from -pi up to pi), without the trig. The
+// float's bits are flipped so the integers sort in the same order.
+std::uint32_t pseudoAngle(sf::Vector2<float> v)
+{
+    float p = v.x / (std::abs(v.x) + std::abs(v.y));
+    auto bits = std::bit_cast<std::uint32_t>(v.y < 0 ? p - 1 : 1 - p);
+    return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+// Keeps the eye off the border, where border edges would be seen edge-on
+sf::Vector2<float> clampInside(sf::Vector2<float> point, const sf::Rect<float> &bounds)
+{
+    sf::Vector2<float> min = bounds.position + sf::Vector2<float>(1, 1);
+    sf::Vector2<float> max = bounds.position + bounds.size - sf::Vector2<float>(1, 1);
+    return {std::clamp(point.x, min.x, std::max(min.x, max.x)), std::clamp(point.y, min.y, std::max(min.y, max.y))};
+}
+} // namespace
+
+// ============= VisibilityPolygon Implementation =============
+
+VisibilityPolygon::VisibilityPolygon() : generation(0), valid(false) {}
+
+bool VisibilityPolygon::update(const World &world, sf::Vector2<float> from, const sf::Rect<float> &bounds)
+{
+    if (valid && clampInside(from, bounds) == eye && bounds == area && world.getStaticGeneration() == generation)
+        return false;
+
+    walls.clear();
+    world.queryWalls(bounds, walls);
+    compute(from, bounds, walls);
+    generation = world.getStaticGeneration();
+    valid = true;
+    return true;
+}
+
+void VisibilityPolygon::addEdge(sf::Vector2<float> a, sf::Vector2<float> b)
+{
+    sf::Vector2<float> da = a - eye, db = b - eye;
+    float turn = da.cross(db);
+    if (turn == 0)
+        return; // Seen edge-on, hides nothing
+    if (turn < 0)
+    {
+        std::swap(a, b);
+        std::swap(da, db);
+    }
+
+    // Crossing the sweep's starting direction (-x, where the pseudo-angle
+    // jumps from 2 to -2) is decided from the sides, not from the angles:
+    // a tiny edge can round to angles in the wrong order, and would then
+    // stay open for the rest of the sweep. One that rounds to no width at
+    // all hides nothing.
+    bool wraps = da.y >= 0 && db.y < 0;
+    std::uint32_t beginAngle = pseudoAngle(da), endAngle = pseudoAngle(db);
+    if (!wraps && beginAngle >= endAngle)
+        return;
+
+    auto index = static_cast<std::uint32_t>(segments.size());
+    segments.push_back({a, b, 0});
+    endpoints.push_back({beginAngle, index, 1});
+    endpoints.push_back({endAngle, index, 0});
+
+    if (wraps)
+    {
+        segments.back().openIndex = static_cast<std::uint32_t>(open.size());
+        open.push_back(index);
+    }
+}
+
+sf::Vector2<float> VisibilityPolygon::hit(std::uint32_t segment, sf::Vector2<float> direction) const
+{
+    // Where the ray from the eye meets the segment's line
+    const Segment &s = segments[segment];
+    sf::Vector2<float> edge = s.end - s.begin;
+    return eye + direction * ((s.begin - eye).cross(edge) / direction.cross(edge));
+}
+
+std::uint32_t VisibilityPolygon::nearest(sf::Vector2<float> direction) const
+{
+    std::uint32_t best = open.front();
+    float bestDistance = std::numeric_limits<float>::max();
+    for (std::uint32_t index : open)
+    {
+        const Segment &s = segments[index];
+        sf::Vector2<float> edge = s.end - s.begin;
+        float distance = (s.begin - eye).cross(edge) / direction.cross(edge);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = index;
+        }
+    }
+    return best;
+}
+
+void VisibilityPolygon::sortEndpoints()
+{
+    // LSD radix sort, 11 bits per pass: linear, where std::sort on the 20k
+    // endpoints of 10k edges took most of the budget
+    constexpr std::uint32_t Bits = 11, Buckets = 1u << Bits;
+    sortScratch.resize(endpoints.size());
+    for (std::uint32_t shift = 0; shift < 32; shift += Bits)
+    {
+        std::array<std::uint32_t, Buckets> offsets{};
+        for (const Endpoint &p : endpoints)
+            ++offsets[(p.angle >> shift) & (Buckets - 1)];
+        std::uint32_t sum = 0;
+        for (std::uint32_t &offset : offsets)
+            sum += std::exchange(offset, sum);
+        for (const Endpoint &p : endpoints)
+            sortScratch[offsets[(p.angle >> shift) & (Buckets - 1)]++] = p;
+        endpoints.swap(sortScratch);
+    }
+}
+
+void VisibilityPolygon::splitOverlaps()
+{
+    // The sweep needs edges that never cross, which overlapping walls break
+    // (the arena's border walls overlap at every corner). Each box, column
+    // by column from the left, has the earlier pieces it overlaps cut out of
+    // it. Only pieces in the bands it spans that reach past the column's
+    // leftmost box can overlap it; walls rarely overlap, so this stays close
+    // to one pass.
+    float columnScale = static_cast<float>(Columns) / area.size.x;
+    float bandScale = static_cast<float>(Bands) / area.size.y;
+    auto columnOf = [&](float x)
+    { return std::min(static_cast<std::size_t>(std::max((x - area.position.x) * columnScale, 0.0f)), Columns - 1); };
+    auto bandOf = [&](float y)
+    { return std::min(static_cast<std::size_t>(std::max((y - area.position.y) * bandScale, 0.0f)), Bands - 1); };
+
+    // Counting sort by column, through 'pieces'
+    std::array<std::uint32_t, Columns + 1> columnEnds{};
+    for (const Box &box : boxes)
+        ++columnEnds[columnOf(box.x0) + 1];
+    for (std::size_t c = 1; c <= Columns; ++c)
+        columnEnds[c] += columnEnds[c - 1];
+    pieces.resize(boxes.size());
+    for (const Box &box : boxes)
+        pieces[columnEnds[columnOf(box.x0)]++] = box; // Leaves each entry at the next column's start
+    boxes.swap(pieces);
+    pieces.clear();
+
+    for (std::vector<Box> &band : active)
+        band.clear();
+    std::array<std::uint32_t, Bands> prunedAt{}; // Column + 1 each band was last pruned at
+
+    for (std::size_t c = 0, begin = 0; c < Columns; begin = columnEnds[c++])
+    {
+        if (begin == columnEnds[c])
+            continue;
+        float left = std::min_element(boxes.begin() + begin, boxes.begin() + columnEnds[c],
+                                      [](const Box &a, const Box &b) { return a.x0 < b.x0; })->x0;
+
+        for (std::size_t i = begin; i < columnEnds[c]; ++i)
+        {
+            const Box &box = boxes[i];
+            fragments.assign(1, box);
+            for (std::size_t b = bandOf(box.y0), last = bandOf(box.y1); b <= last; ++b)
+            {
+                if (prunedAt[b] != c + 1)
+                {
+                    std::erase_if(active[b], [&](const Box &piece) { return piece.x1 <= left; });
+                    prunedAt[b] = static_cast<std::uint32_t>(c + 1);
+                }
+                for (const Box &cut : active[b])
+                {
+                    for (std::size_t f = 0; f < fragments.size();)
+                    {
+                        Box a = fragments[f];
+                        if (a.x0 >= cut.x1 || cut.x0 >= a.x1 || a.y0 >= cut.y1 || cut.y0 >= a.y1)
+                        {
+                            ++f;
+                            continue;
+                        }
+                        fragments[f] = fragments.back();
+                        fragments.pop_back();
+
+                        // What is left of 'a' around 'cut': full-height sides,
+                        // then the parts above and below the overlap
+                        float x0 = std::max(a.x0, cut.x0), x1 = std::min(a.x1, cut.x1);
+                        if (a.x0 < cut.x0)
+                            fragments.push_back({a.x0, a.y0, cut.x0, a.y1});
+                        if (cut.x1 < a.x1)
+                            fragments.push_back({cut.x1, a.y0, a.x1, a.y1});
+                        if (a.y0 < cut.y0)
+                            fragments.push_back({x0, a.y0, x1, cut.y0});
+                        if (cut.y1 < a.y1)
+                            fragments.push_back({x0, cut.y1, x1, a.y1});
+                    }
+                }
+            }
+            for (const Box &fragment : fragments)
+            {
+                pieces.push_back(fragment);
+                for (std::size_t b = bandOf(fragment.y0), last = bandOf(fragment.y1); b <= last; ++b)
+                    active[b].push_back(fragment);
+            }
+        }
+    }
+}
+
+void VisibilityPolygon::compute(sf::Vector2<float> from, const sf::Rect<float> &bounds,
+                                std::span<const sf::Rect<float>> occluders)
+{
+    eye = clampInside(from, bounds);
+    area = bounds;
+    segments.clear();
+    endpoints.clear();
+    open.clear();
+    fan.clear();
+
+    // The border closes the polygon wherever no wall does
+    sf::Vector2<float> p0 = bounds.position, p1 = bounds.position + bounds.size;
+    addEdge(p0, {p1.x, p0.y});
+    addEdge({p1.x, p0.y}, p1);
+    addEdge(p1, {p0.x, p1.y});
+    addEdge({p0.x, p1.y}, p0);
+
+    // Walls are clipped to the area, so none crosses the border. One
+    // containing the eye occludes nothing.
+    boxes.clear();
+    for (const sf::Rect<float> &wall : occluders)
+    {
+        std::optional<sf::Rect<float>> clipped = wall.findIntersection(bounds);
+        if (!clipped)
+            continue;
+        sf::Vector2<float> w0 = clipped->position, w1 = clipped->position + clipped->size;
+        if (eye.x < w0.x || eye.x > w1.x || eye.y < w0.y || eye.y > w1.y)
+            boxes.push_back({w0.x, w0.y, w1.x, w1.y});
+    }
+    splitOverlaps();
+
+    // A solid rectangle only occludes with the (at most two) sides facing
+    // the eye
+    for (const Box &box : pieces)
+    {
+        if (eye.x < box.x0)
+            addEdge({box.x0, box.y0}, {box.x0, box.y1});
+        else if (eye.x > box.x1)
+            addEdge({box.x1, box.y0}, {box.x1, box.y1});
+        if (eye.y < box.y0)
+            addEdge({box.x0, box.y0}, {box.x1, box.y0});
+        else if (eye.y > box.y1)
+            addEdge({box.x0, box.y1}, {box.x1, box.y1});
+    }
+
+    sortEndpoints();
+
+    auto directionOf = [this](const Endpoint &p)
+    {
+        const Segment &s = segments[p.segment];
+        return (p.begin ? s.begin : s.end) - eye;
+    };
+
+    // Between two consecutive endpoint angles the open set is fixed, and
+    // so is the nearest segment (no two edges cross): test it along a
+    // direction in between (the sum of the two, as they are less than pi
+    // apart), and only when it may have changed
+    sf::Vector2<float> first = directionOf(endpoints.front());
+    std::uint32_t current = nearest(directionOf(endpoints.back()) + first);
+    fan.push_back({eye});
+
+    for (std::size_t i = 0; i < endpoints.size();)
+    {
+        std::uint32_t angle = endpoints[i].angle;
+        sf::Vector2<float> direction = directionOf(endpoints[i]);
+        std::size_t group = i;
+        bool lost = false, opened = false;
+        for (; i < endpoints.size() && endpoints[i].angle == angle; ++i)
+        {
+            const Endpoint &p = endpoints[i];
+            Segment &s = segments[p.segment];
+            if (p.begin)
+            {
+                s.openIndex = static_cast<std::uint32_t>(open.size());
+                open.push_back(p.segment);
+                opened = true;
+                continue;
+            }
+            std::uint32_t moved = open.back();
+            open[s.openIndex] = moved;
+            segments[moved].openIndex = s.openIndex;
+            open.pop_back();
+            lost |= p.segment == current;
+        }
+
+        if (!lost && !opened)
+            continue;
+        sf::Vector2<float> mid = direction + (i < endpoints.size() ? directionOf(endpoints[i]) : first);
+        std::uint32_t next = current;
+        if (lost)
+            next = nearest(mid);
+        else
+        {
+            const Segment &s = segments[current];
+            sf::Vector2<float> edge = s.end - s.begin;
+            float best = (s.begin - eye).cross(edge) / mid.cross(edge);
+            for (std::size_t j = group; j < i; ++j)
+            {
+                if (!endpoints[j].begin)
+                    continue;
+                const Segment &candidate = segments[endpoints[j].segment];
+                edge = candidate.end - candidate.begin;
+                float distance = (candidate.begin - eye).cross(edge) / mid.cross(edge);
+                if (distance < best)
+                {
+                    best = distance;
+                    next = endpoints[j].segment;
+                }
+            }
+        }
+
+        if (next != current)
+        {
+            fan.push_back({hit(current, direction)});
+            fan.push_back({hit(next, direction)});
+            current = next;
+        }
+    }
+    fan.push_back(fan[1]); // Close the loop
+}
+
+std::size_t VisibilityPolygon::countRayMismatches(std::span<const sf::Rect<float>> occluders,
+                                                  std::uint32_t rays) const
+{
+    if (fan.size() < 4)
+        return rays;
+
+    std::size_t mismatches = 0;
+    sf::Vector2<float> p0 = area.position, p1 = area.position + area.size;
+    for (std::uint32_t r = 0; r < rays; ++r)
+    {
+        // Off the round angles that walls and corners tend to sit on
+        float angle = (static_cast<float>(r) + 0.37f) * 6.2831853f / static_cast<float>(rays);
+        sf::Vector2<float> d(std::cos(angle), std::sin(angle));
+
+        // Brute force: where the ray leaves the area, or first enters a wall
+        // (slab test). Walls containing the eye are ignored, as in compute().
+        float expected = std::numeric_limits<float>::max();
+        if (d.x != 0)
+            expected = std::min(expected, ((d.x > 0 ? p1.x : p0.x) - eye.x) / d.x);
+        if (d.y != 0)
+            expected = std::min(expected, ((d.y > 0 ? p1.y : p0.y) - eye.y) / d.y);
+        for (const sf::Rect<float> &wall : occluders)
+        {
+            sf::Vector2<float> w0 = wall.position, w1 = wall.position + wall.size;
+            if (eye.x >= w0.x && eye.x <= w1.x && eye.y >= w0.y && eye.y <= w1.y)
+                continue;
+            float enter = 0, leave = std::numeric_limits<float>::max();
+            for (int axis = 0; axis < 2; ++axis)
+            {
+                float o = axis ? eye.y : eye.x, v = axis ? d.y : d.x;
+                float lo = axis ? w0.y : w0.x, hi = axis ? w1.y : w1.x;
+                if (v == 0)
+                {
+                    if (o <= lo || o >= hi)
+                        enter = leave; // Parallel and outside: missed
+                    continue;
+                }
+                float t0 = (lo - o) / v, t1 = (hi - o) / v;
+                enter = std::max(enter, std::min(t0, t1));
+                leave = std::min(leave, std::max(t0, t1));
+            }
+            if (enter < leave)
+                expected = std::min(expected, enter);
+        }
+
+        // The polygon: the boundary edge between the two fan vertices the
+        // ray passes between (they go counterclockwise around the eye)
+        float found = -1;
+        for (std::size_t i = 1; i + 1 < fan.size(); ++i)
+        {
+            sf::Vector2<float> a = fan[i].position - eye, b = fan[i + 1].position - eye;
+            sf::Vector2<float> edge = b - a;
+            float along = d.cross(edge);
+            if (a.cross(d) < 0 || d.cross(b) < 0 || a.cross(b) < 0 || along == 0)
+                continue;
+            found = a.cross(edge) / along;
+            break;
+        }
+        if (std::abs(found - expected) > 0.01f + expected * 1e-3f)
+            ++mismatches;
+    }
+    return mismatches;
+}
+
+void VisibilityPolygon::drawFog(sf::RenderTarget &target, sf::Color fog) const
+{
+    if (fan.size() < 4)
+        return;
+
+    target.clearStencil(0);
+    sf::RenderStates mask;
+    mask.stencilMode = {sf::StencilComparison::Always, sf::StencilUpdateOperation::Replace, 1u, ~0u, true};
+    target.draw(fan.data(), fan.size(), sf::PrimitiveType::TriangleFan, mask);
+
+    sf::RenderStates outside;
+    outside.stencilMode = {sf::StencilComparison::NotEqual, sf::StencilUpdateOperation::Keep, 1u, ~0u, false};
+    sf::Vector2<float> p0 = area.position, p1 = area.position + area.size;
+    const sf::Vertex quad[] = {{p0, fog}, {{p1.x, p0.y}, fog}, {{p0.x, p1.y}, fog}, {p1, fog}};
+    target.draw(quad, 4, sf::PrimitiveType::TriangleStrip, outside);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "World.h"
+
+// What can be seen from one point (fog of war): the region bounded by the
+// nearest wall in every direction, clipped to a rectangle. Computed with an
+// angular sweep over the wall edges facing the eye, and only recomputed when
+// the eye, the rectangle or the level changes.
+class VisibilityPolygon
+{
+private:
+    struct Segment
+    {
+        sf::Vector2<float> begin, end; // Counterclockwise around the eye
+        std::uint32_t openIndex;       // Position in 'open' while the sweep is inside it
+    };
+
+    struct Endpoint
+    {
+        std::uint32_t angle; // Pseudo-angle as an integer, monotonic in the true one
+        std::uint32_t segment : 31;
+        std::uint32_t begin : 1;
+    };
+
+    // Occluder as corners, so pieces split from it share exact coordinates
+    struct Box
+    {
+        float x0, y0, x1, y1;
+    };
+
+    // Grid over the area for splitOverlaps(): boxes are visited column by
+    // column, pieces are filed under the bands they span
+    static constexpr std::size_t Columns = 256;
+    static constexpr std::size_t Bands = 32;
+
+    std::vector<sf::Rect<float>> walls; // Scratch: walls near the area
+    std::vector<Box> boxes;             // Occluders clipped to the area
+    std::vector<Box> pieces;            // The same area split so that no two overlap
+    std::vector<Box> fragments;         // Scratch for splitting one box
+    std::array<std::vector<Box>, Bands> active; // Pieces later boxes may still overlap, by band
+    std::vector<Segment> segments;
+    std::vector<Endpoint> endpoints;
+    std::vector<Endpoint> sortScratch;
+    std::vector<std::uint32_t> open; // Segments crossing the current sweep direction
+    std::vector<sf::Vertex> fan;     // Triangle fan: the eye, then the boundary
+
+    sf::Vector2<float> eye;
+    sf::Rect<float> area;
+    std::uint32_t generation;
+    bool valid;
+
+    void addEdge(sf::Vector2<float> a, sf::Vector2<float> b);
+    void splitOverlaps();
+    void sortEndpoints();
+    std::uint32_t nearest(sf::Vector2<float> direction) const;
+    sf::Vector2<float> hit(std::uint32_t segment, sf::Vector2<float> direction) const;
+
+public:
+    VisibilityPolygon();
+
+    // Recomputes from the world's walls if anything changed since the last
+    // call; returns whether it did. 'from' is kept inside 'bounds'.
+    bool update(const World &world, sf::Vector2<float> from, const sf::Rect<float> &bounds);
+    // The sweep itself, against the given wall rectangles
+    void compute(sf::Vector2<float> from, const sf::Rect<float> &bounds, std::span<const sf::Rect<float>> occluders);
+
+    // Writes the polygon to the stencil buffer, then covers everything
+    // outside it with 'fog'. Needs a target with a stencil buffer.
+    void drawFog(sf::RenderTarget &target, sf::Color fog) const;
+
+    const std::vector<sf::Vertex> &getFan() const { return fan; }
+    std::size_t getEdgeCount() const { return segments.size(); }
+
+    // Brute-force cross-check of the last compute(): casts 'rays' rays from
+    // the eye against every occluder and the border and compares where they
+    // stop with the polygon's boundary. Returns how many disagree. Slow;
+    // for benchmarks and debugging.
+    std::size_t countRayMismatches(std::span<const sf::Rect<float>> occluders, std::uint32_t rays) const;
+};
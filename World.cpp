@@ -0,0 +1,547 @@
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// Lockstep relies on identical float results everywhere. IEEE 754 makes the
+// basic operations and std::sqrt exact-rounded; what breaks that is value-
+// changing optimization, so refuse to build with it. Also build with
+// -ffp-contract=off (see README) so no compiler fuses a*b+c into an FMA.
+static_assert(std::numeric_limits<float>::is_iec559, "Simulation requires IEEE 754 floats");
+#if defined(__FAST_MATH__)
+#error "Do not build the simulation with -ffast-math; it breaks deterministic lockstep"
+#endif
+
+// ============= StaticLayer Implementation =============
+
+StaticLayer StaticLayer::build(std::shared_ptr<const Level> source)
+{
+    StaticLayer layer;
+    layer.level = std::move(source);
+    const Level &level = *layer.level;
+
+    const LevelRect *levelWalls = level.getWalls();
+    layer.walls.reserve(level.getWallCount());
+    for (std::uint32_t i = 0; i < level.getWallCount(); ++i)
+        layer.walls.emplace_back(levelWalls[i].x, levelWalls[i].y, levelWalls[i].w, levelWalls[i].h);
+
+    const LevelDestructible *levelDest = level.getDestructibles();
+    layer.destructibles.reserve(level.getDestructibleCount());
+    for (std::uint32_t i = 0; i < level.getDestructibleCount(); ++i)
+    {
+        const LevelDestructible &d = levelDest[i];
+        layer.destructibles.emplace_back(d.x, d.y, d.w, d.h, d.health);
+    }
+    return layer;
+}
+
+// ============= World Implementation =============
+
+World::World() : World(Level::builtin()) {}
+
+World::World(std::shared_ptr<const Level> source) : World(std::move(source), nullptr) {}
+
+World::World(std::shared_ptr<const Level> source, ChunkStreamer *chunks)
+    : World(chunks ? StaticLayer{std::move(source), {}, {}} : StaticLayer::build(std::move(source)), chunks) {}
+
+World::World(StaticLayer layer, ChunkStreamer *chunks)
+    : level(std::move(layer.level)), nextId(1), tick(0), staticGeneration(0), streamer(chunks), centerX(0), centerY(0)
+{
+    const LevelSpawn *spawns = level->getSpawns();
+    const LevelSpawn *playerSpawn = nullptr;
+    for (std::uint32_t i = 0; i < level->getSpawnCount() && !playerSpawn; ++i)
+        if (spawns[i].kind == static_cast<std::uint32_t>(LevelFormat::SpawnKind::Player))
+            playerSpawn = &spawns[i];
+
+    player = playerSpawn ? std::make_unique<Player>(playerSpawn->x, playerSpawn->y)
+                         : std::make_unique<Player>(400, 300);
+    spawn(*player);
+
+    if (streamer)
+    {
+        refreshChunks(true);
+        return;
+    }
+
+    walls = std::move(layer.walls);
+    destructibles = std::move(layer.destructibles);
+    for (Wall &wall : walls)
+        spawn(wall);
+    for (DestructibleObject &dest : destructibles)
+        spawn(dest);
+
+    for (std::uint32_t i = 0; i < level->getSpawnCount(); ++i)
+    {
+        if (spawns[i].kind == static_cast<std::uint32_t>(LevelFormat::SpawnKind::Enemy))
+        {
+            enemies.push_back(std::make_unique<Enemy>(spawns[i].x, spawns[i].y, player.get()));
+            spawn(*enemies.back());
+        }
+    }
+}
+
+void World::swapStaticLayer(StaticLayer &layer)
+{
+    std::swap(level, layer.level);
+    walls.swap(layer.walls);
+    destructibles.swap(layer.destructibles);
+
+    for (Wall &wall : walls)
+        spawn(wall);
+    for (DestructibleObject &dest : destructibles)
+        spawn(dest);
+    ++staticGeneration;
+}
+
+void World::handleShooting(const PlayerInput &input)
+{
+    if (input.shoot && player->tryShoot())
+    {
+        sf::Vector2<float> pPos = player->getPosition();
+
+        float dx = input.aim.x - (pPos.x + 15);
+        float dy = input.aim.y - (pPos.y + 15);
+
+        projectiles.push_back(
+            std::make_unique<Projectile>(pPos.x + 15, pPos.y + 15, dx, dy));
+        spawn(*projectiles.back());
+        events.push_back({WorldEvent::Type::Shot, {pPos.x + 15, pPos.y + 15}, {dx, dy}});
+    }
+}
+
+void World::update(const PlayerInput &input, float dt)
+{
+    events.clear();
+    staticChanges.clear();
+    destructibleChanges.clear();
+    if (streamer)
+        refreshChunks(false);
+    handleShooting(input);
+
+    player->handleInput(input, dt);
+    player->update(dt);
+
+    for (auto &enemy : enemies)
+        enemy->update(dt);
+    for (auto &proj : projectiles)
+        proj->update(dt);
+    for (DestructibleObject &dest : destructibles)
+        dest.update(dt);
+
+    handleCollisions();
+    cleanupInactive();
+    ++tick;
+}
+
+std::uint64_t World::checksum() const
+{
+    StateHash hash;
+    hash.add(tick);
+    hash.add(nextId);
+
+    player->hashState(hash);
+    for (const auto &enemy : enemies)
+        enemy->hashState(hash);
+    for (const auto &proj : projectiles)
+        proj->hashState(hash);
+    for (const DestructibleObject &dest : destructibles)
+        dest.hashState(hash);
+    return hash.get();
+}
+
+void World::saveSnapshot(WorldSnapshot &out) const
+{
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SnapshotFormat::Magic, sizeof(header.magic));
+    header.version = SnapshotFormat::Version;
+    header.byteOrder = SnapshotFormat::ByteOrderMark;
+    header.tick = tick;
+    header.nextId = nextId;
+    header.wallCount = static_cast<std::uint32_t>(walls.size());
+    header.levelHash = level->getSourceHash();
+    header.enemyCount = static_cast<std::uint32_t>(enemies.size());
+    header.projectileCount = static_cast<std::uint32_t>(projectiles.size());
+    header.destructibleCount = static_cast<std::uint32_t>(destructibles.size());
+    out.begin(header);
+
+    player->saveState(out.getPlayer());
+    EnemyRecord *enemyOut = out.getEnemies();
+    for (std::size_t i = 0; i < enemies.size(); ++i)
+        enemies[i]->saveState(enemyOut[i]);
+    ProjectileRecord *projOut = out.getProjectiles();
+    for (std::size_t i = 0; i < projectiles.size(); ++i)
+        projectiles[i]->saveState(projOut[i]);
+    DestructibleRecord *destOut = out.getDestructibles();
+    for (std::size_t i = 0; i < destructibles.size(); ++i)
+        destructibles[i].saveState(destOut[i]);
+}
+
+bool World::loadSnapshot(const WorldSnapshot &in)
+{
+    if (!in.isValid() || streamer)
+        return false;
+    const SnapshotHeader &header = in.getHeader();
+    if (header.wallCount != walls.size() || header.levelHash != level->getSourceHash())
+    {
+        std::cerr << "Snapshot was taken on a different level\n";
+        return false;
+    }
+
+    tick = header.tick;
+    nextId = header.nextId;
+    ++staticGeneration; // Destructibles may differ anywhere
+    player->loadState(in.getPlayer());
+
+    // Objects are recycled; only a snapshot with more of a kind allocates
+    enemies.resize(header.enemyCount);
+    const EnemyRecord *enemyIn = in.getEnemies();
+    for (std::uint32_t i = 0; i < header.enemyCount; ++i)
+    {
+        if (!enemies[i])
+            enemies[i] = std::make_unique<Enemy>(0, 0, player.get());
+        enemies[i]->loadState(enemyIn[i]);
+    }
+
+    projectiles.resize(header.projectileCount);
+    const ProjectileRecord *projIn = in.getProjectiles();
+    for (std::uint32_t i = 0; i < header.projectileCount; ++i)
+    {
+        if (!projectiles[i])
+            projectiles[i] = std::make_unique<Projectile>(0, 0, 0, 0);
+        projectiles[i]->loadState(projIn[i]);
+    }
+
+    destructibles.resize(header.destructibleCount, DestructibleObject(0, 0, 0, 0, 1));
+    const DestructibleRecord *destIn = in.getDestructibles();
+    for (std::uint32_t i = 0; i < header.destructibleCount; ++i)
+        destructibles[i].loadState(destIn[i]);
+    return true;
+}
+
+void World::render(RenderQueue &queue, const sf::Rect<float> &visible) const
+{
+    renderStatic(queue, visible);
+    renderDynamic(queue, visible);
+}
+
+void World::renderStatic(RenderQueue &queue, const sf::Rect<float> &visible) const
+{
+    renderWalls(queue, visible);
+    renderDestructibles(queue, visible);
+}
+
+void World::renderWalls(RenderQueue &queue, const sf::Rect<float> &visible) const
+{
+    // BVH leaves may hold a few walls just off screen; drawing them is
+    // cheaper than testing each one
+    if (streamer)
+    {
+        for (const ActiveChunk &chunk : activeChunks)
+        {
+            visibleWalls.clear();
+            chunk.data->getWallBvh().query(visible, visibleWalls);
+            for (std::uint32_t index : visibleWalls)
+                chunk.walls[index].render(queue);
+        }
+    }
+    else
+    {
+        visibleWalls.clear();
+        level->getWallBvh().query(visible, visibleWalls);
+        for (std::uint32_t index : visibleWalls)
+            walls[index].render(queue);
+    }
+}
+
+void World::renderDestructibles(RenderQueue &queue, const sf::Rect<float> &visible) const
+{
+    for (const DestructibleObject &dest : destructibles)
+        if (visible.findIntersection(dest.getBounds()))
+            dest.render(queue);
+}
+
+void World::queryWalls(const sf::Rect<float> &area, std::vector<sf::Rect<float>> &out) const
+{
+    if (streamer)
+    {
+        for (const ActiveChunk &chunk : activeChunks)
+        {
+            visibleWalls.clear();
+            chunk.data->getWallBvh().query(area, visibleWalls);
+            for (std::uint32_t index : visibleWalls)
+                out.push_back(chunk.walls[index].getBounds());
+        }
+        return;
+    }
+    visibleWalls.clear();
+    level->getWallBvh().query(area, visibleWalls);
+    for (std::uint32_t index : visibleWalls)
+        out.push_back(walls[index].getBounds());
+}
+
+void World::renderDynamic(RenderQueue &queue, const sf::Rect<float> &visible) const
+{
+    auto onScreen = [&](const GameObject &obj)
+    { return visible.findIntersection(obj.getBounds()).has_value(); };
+    player->render(queue);
+    for (const auto &enemy : enemies)
+        if (onScreen(*enemy))
+            enemy->render(queue);
+    for (const auto &proj : projectiles)
+        if (onScreen(*proj))
+            proj->render(queue);
+}
+
+void World::resolveWallHits(const std::vector<Wall> &candidates)
+{
+    std::sort(wallHits.begin(), wallHits.end()); // Resolve in level order, as before
+
+    for (std::uint32_t index : wallHits)
+    {
+        const Wall &wall = candidates[index];
+        if (wall.getActive())
+        {
+            sf::Rect<float> pBounds = player->getBounds();
+            sf::Rect<float> wBounds = wall.getBounds();
+
+            // SFML 3.x: findIntersection returns an optional
+            if (const auto intersection = pBounds.findIntersection(wBounds))
+            {
+                sf::Vector2<float> pPos = player->getPosition();
+                float overlapX = intersection->size.x;
+                float overlapY = intersection->size.y;
+
+                if (overlapX < overlapY)
+                {
+                    if (pBounds.position.x < wBounds.position.x)
+                        pPos.x -= overlapX;
+                    else
+                        pPos.x += overlapX;
+                }
+                else
+                {
+                    if (pBounds.position.y < wBounds.position.y)
+                        pPos.y -= overlapY;
+                    else
+                        pPos.y += overlapY;
+                }
+                player->setPosition(pPos); // Update player position
+            }
+        }
+    }
+}
+
+void World::handleCollisions()
+{
+    // Player vs walls, narrowed by the level's precomputed BVH, or by each
+    // active chunk's own when streaming
+    if (streamer)
+    {
+        for (const ActiveChunk &chunk : activeChunks)
+        {
+            wallHits.clear();
+            chunk.data->getWallBvh().query(player->getBounds(), wallHits);
+            resolveWallHits(chunk.walls);
+        }
+    }
+    else
+    {
+        wallHits.clear();
+        level->getWallBvh().query(player->getBounds(), wallHits);
+        resolveWallHits(walls);
+    }
+
+    // Projectiles vs entities
+    for (auto &proj : projectiles)
+    {
+        if (!proj->getActive())
+            continue;
+
+        // vs enemies
+        for (auto &enemy : enemies)
+        {
+            if (enemy->getActive() && proj->getBounds().findIntersection(enemy->getBounds()).has_value())
+            {
+                proj->setActive(false);
+                enemy->setActive(false);
+                events.push_back({WorldEvent::Type::EnemyKilled, enemy->getBounds().getCenter(), proj->getVelocity()});
+                break;
+            }
+        }
+
+        if (!proj->getActive())
+            continue; // Check again in case it hit an enemy
+
+        // vs destructibles
+        for (DestructibleObject &dest : destructibles)
+        {
+            if (dest.getActive() && proj->getBounds().findIntersection(dest.getBounds()).has_value())
+            {
+                proj->setActive(false);
+                dest.takeDamage(25.0f); // Also recolours it
+                destructibleChanges.push_back(dest.getId());
+                events.push_back({dest.getActive() ? WorldEvent::Type::Hit : WorldEvent::Type::DestructibleDestroyed,
+                                  proj->getBounds().getCenter(), proj->getVelocity()});
+                break;
+            }
+        }
+    }
+}
+
+void World::cleanupInactive()
+{
+    std::erase_if(projectiles, [](const auto &p)
+                  { return !p->getActive(); });
+    std::erase_if(enemies, [](const auto &e)
+                  { return !e->getActive(); });
+    std::erase_if(destructibles, [this](const DestructibleObject &d)
+                  {
+                      if (d.getActive())
+                          return false;
+                      if (auto source = destructibleSource.find(d.getId()); source != destructibleSource.end())
+                      {
+                          savedHealth[source->second] = 0; // Stays destroyed when its chunk reloads
+                          destructibleSource.erase(source);
+                      }
+                      return true; });
+}
+
+// ============= World streaming =============
+
+static std::int32_t chunkOf(float v) { return static_cast<std::int32_t>(std::floor(v / LevelFormat::ChunkSize)); }
+
+static sf::Rect<float> chunkBounds(const LevelChunkData &data)
+{
+    return {{static_cast<float>(data.x) * LevelFormat::ChunkSize, static_cast<float>(data.y) * LevelFormat::ChunkSize},
+            {LevelFormat::ChunkSize, LevelFormat::ChunkSize}};
+}
+
+static std::uint64_t chunkKey(std::int32_t x, std::int32_t y)
+{
+    return (std::uint64_t(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+void World::refreshChunks(bool force)
+{
+    sf::Vector2<float> center = player->getBounds().getCenter();
+    std::int32_t cx = chunkOf(center.x), cy = chunkOf(center.y);
+    if (!force && cx == centerX && cy == centerY)
+        return;
+    centerX = cx;
+    centerY = cy;
+    streamer->prefetch(cx, cy, PrefetchRadius);
+
+    // One chunk of hysteresis, so walking along a border does not thrash
+    for (std::size_t i = activeChunks.size(); i-- > 0;)
+    {
+        const LevelChunkData &data = *activeChunks[i].data;
+        if (std::abs(data.x - cx) > ActiveRadius + 1 || std::abs(data.y - cy) > ActiveRadius + 1)
+            deactivateChunk(i);
+    }
+
+    for (std::int32_t y = cy - ActiveRadius; y <= cy + ActiveRadius; ++y)
+    {
+        for (std::int32_t x = cx - ActiveRadius; x <= cx + ActiveRadius; ++x)
+        {
+            bool active = std::any_of(activeChunks.begin(), activeChunks.end(), [&](const ActiveChunk &chunk)
+                                      { return chunk.data->x == x && chunk.data->y == y; });
+            if (!active)
+            {
+                if (std::shared_ptr<const LevelChunkData> data = streamer->acquire(x, y))
+                    activateChunk(std::move(data));
+            }
+        }
+    }
+}
+
+void World::activateChunk(std::shared_ptr<const LevelChunkData> data)
+{
+    ActiveChunk chunk;
+    chunk.walls.reserve(data->walls.size());
+    for (const LevelRect &rect : data->walls)
+    {
+        chunk.walls.emplace_back(rect.x, rect.y, rect.w, rect.h);
+        spawn(chunk.walls.back());
+    }
+
+    for (std::uint32_t i = 0; i < data->destructibles.size(); ++i)
+    {
+        const LevelDestructible &d = data->destructibles[i];
+        std::uint32_t source = data->destructibleFirst + i;
+        auto saved = savedHealth.find(source);
+        if (saved != savedHealth.end() && saved->second <= 0)
+            continue; // Destroyed on an earlier visit
+
+        DestructibleObject &dest = destructibles.emplace_back(d.x, d.y, d.w, d.h, d.health);
+        if (saved != savedHealth.end())
+        {
+            dest.takeDamage(d.health - saved->second); // Also restores the damage colour
+            savedHealth.erase(saved);
+        }
+        spawn(dest);
+        destructibleSource[dest.getId()] = source;
+        destructibleChanges.push_back(dest.getId());
+    }
+
+    std::uint64_t key = chunkKey(data->x, data->y);
+    if (seededChunks.insert(key).second)
+    {
+        for (const LevelSpawn &s : data->spawns)
+        {
+            if (s.kind == static_cast<std::uint32_t>(LevelFormat::SpawnKind::Enemy))
+            {
+                enemies.push_back(std::make_unique<Enemy>(s.x, s.y, player.get()));
+                spawn(*enemies.back());
+            }
+        }
+    }
+    else if (auto dormant = dormantEnemies.find(key); dormant != dormantEnemies.end())
+    {
+        for (const EnemyRecord &record : dormant->second)
+        {
+            enemies.push_back(std::make_unique<Enemy>(0, 0, player.get()));
+            enemies.back()->loadState(record); // Keeps its id
+        }
+        dormantEnemies.erase(dormant);
+    }
+
+    staticChanges.push_back(chunkBounds(*data));
+    chunk.data = std::move(data);
+    activeChunks.push_back(std::move(chunk));
+}
+
+void World::deactivateChunk(std::size_t index)
+{
+    const LevelChunkData &data = *activeChunks[index].data;
+    std::uint32_t first = data.destructibleFirst;
+    auto count = static_cast<std::uint32_t>(data.destructibles.size());
+
+    std::erase_if(destructibles, [&](const DestructibleObject &d)
+                  {
+                      auto source = destructibleSource.find(d.getId());
+                      if (source == destructibleSource.end() || source->second - first >= count)
+                          return false;
+                      savedHealth[source->second] = d.getHealth();
+                      destructibleSource.erase(source);
+                      destructibleChanges.push_back(d.getId());
+                      return true; });
+
+    // Enemies standing in the chunk go dormant until it is activated again
+    std::vector<EnemyRecord> &dormant = dormantEnemies[chunkKey(data.x, data.y)];
+    std::erase_if(enemies, [&](const auto &e)
+                  {
+                      sf::Vector2<float> center = e->getBounds().getCenter();
+                      if (chunkOf(center.x) != data.x || chunkOf(center.y) != data.y)
+                          return false;
+                      dormant.emplace_back();
+                      e->saveState(dormant.back());
+                      return true; });
+    if (dormant.empty())
+        dormantEnemies.erase(chunkKey(data.x, data.y));
+
+    staticChanges.push_back(chunkBounds(data));
+    activeChunks.erase(activeChunks.begin() + static_cast<std::ptrdiff_t>(index));
+}
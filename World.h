@@ -0,0 +1,159 @@
+#pragma once
+
+#include <SFML/Graphics/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ChunkStreamer.h"
+#include "Entity.h"
+#include "Level.h"
+#include "PlayerInput.h"
+#include "Projectile.h"
+#include "Snapshot.h"
+#include "StaticObject.h"
+
+// Level-derived objects, built without touching a World so that a reload
+// can prepare them on a background thread and swap them in between ticks.
+// Held by value: a level of any size costs two allocations to instantiate.
+struct StaticLayer
+{
+    std::shared_ptr<const Level> level;
+    std::vector<Wall> walls;
+    std::vector<DestructibleObject> destructibles;
+
+    static StaticLayer build(std::shared_ptr<const Level> source);
+};
+
+// Something a client may want to show (effects, sounds), gathered during
+// update() and replaced by the next one. Not part of the simulation state.
+struct WorldEvent
+{
+    enum class Type : std::uint8_t
+    {
+        Shot,                 // At the muzzle, along the aim
+        Hit,                  // Projectile hit a destructible that survived
+        EnemyKilled,
+        DestructibleDestroyed
+    };
+
+    Type type;
+    sf::Vector2<float> position;
+    sf::Vector2<float> direction; // Not normalized; zero when there is none
+};
+
+// Complete simulation state of one match. Holds no window and no globals, so
+// any number of worlds can run side by side (one per match on a server).
+class World
+{
+private:
+    std::unique_ptr<Player> player;
+    std::vector<std::unique_ptr<Enemy>> enemies;
+    std::vector<std::unique_ptr<Projectile>> projectiles;
+    std::vector<Wall> walls;
+    std::vector<DestructibleObject> destructibles;
+
+    std::shared_ptr<const Level> level;
+    std::vector<std::uint32_t> wallHits; // Scratch for broadphase queries
+    mutable std::vector<std::uint32_t> visibleWalls; // Scratch for render culling
+
+    std::uint32_t nextId;
+    std::uint32_t tick;
+    std::vector<WorldEvent> events; // From the last update()
+
+    // For caches of the static layer's rendering: areas where walls changed
+    // during the last update(), ids of destructibles damaged, destroyed,
+    // streamed in or unloaded during it, and a counter bumped when all of
+    // them may have changed (layer swap, snapshot restore)
+    std::vector<sf::Rect<float>> staticChanges;
+    std::vector<std::uint32_t> destructibleChanges;
+    std::uint32_t staticGeneration;
+
+    // Streaming (chunked levels): only chunks around the player exist as
+    // objects. Activation is synchronous and depends only on the player's
+    // position, so streamed worlds stay deterministic.
+    struct ActiveChunk
+    {
+        std::shared_ptr<const LevelChunkData> data;
+        std::vector<Wall> walls; // Index-aligned with data->walls
+    };
+    ChunkStreamer *streamer;
+    std::vector<ActiveChunk> activeChunks;
+    std::int32_t centerX, centerY; // Player's chunk at the last refresh
+    std::unordered_map<std::uint32_t, std::uint32_t> destructibleSource; // Object id -> level index
+    std::unordered_map<std::uint32_t, float> savedHealth; // Level index -> health while unloaded, 0 = destroyed
+    std::unordered_map<std::uint64_t, std::vector<EnemyRecord>> dormantEnemies; // By chunk key
+    std::unordered_set<std::uint64_t> seededChunks; // Chunks whose level enemies were already spawned
+
+    void spawn(GameObject &obj) { obj.setId(nextId++); }
+    void refreshChunks(bool force);
+    void activateChunk(std::shared_ptr<const LevelChunkData> data);
+    void deactivateChunk(std::size_t index);
+    void resolveWallHits(const std::vector<Wall> &candidates);
+    void handleShooting(const PlayerInput &input);
+    void handleCollisions();
+    void cleanupInactive();
+
+public:
+    // Step used by the server, lockstep and replays. Simulating with this dt on
+    // every machine is what makes update() reproducible bit for bit.
+    static constexpr float FixedDt = 1.0f / 60.0f;
+
+    // Chunks instantiated around the player's chunk, and how far ahead the
+    // streamer is asked to load
+    static constexpr std::int32_t ActiveRadius = 1;
+    static constexpr std::int32_t PrefetchRadius = 3;
+
+    World();
+    // Walls are index-aligned with the level so its BVH can be used directly
+    explicit World(std::shared_ptr<const Level> source);
+    // Chunked level streamed through 'chunks', which must outlive the world
+    World(std::shared_ptr<const Level> source, ChunkStreamer *chunks);
+    // From a layer prebuilt off-thread (walls and destructibles are unused
+    // when streaming, so the layer may hold just the level)
+    World(StaticLayer layer, ChunkStreamer *chunks);
+
+    // Replaces walls, destructibles and the broadphase with a prebuilt layer;
+    // the player, enemies and projectiles carry over. O(1) apart from id
+    // assignment. The old layer is left in 'layer' to be freed off-thread.
+    void swapStaticLayer(StaticLayer &layer);
+
+    void update(const PlayerInput &input, float dt);
+    // Submits only what overlaps 'visible' (world space): walls through the
+    // BVH, everything else with a bounds test
+    void render(RenderQueue &queue, const sf::Rect<float> &visible) const;
+    // The two halves of render(): walls and destructibles, then the actors
+    // and projectiles. renderStatic() is renderWalls() then
+    // renderDestructibles(), for callers that cache them separately.
+    void renderStatic(RenderQueue &queue, const sf::Rect<float> &visible) const;
+    void renderWalls(RenderQueue &queue, const sf::Rect<float> &visible) const;
+    void renderDestructibles(RenderQueue &queue, const sf::Rect<float> &visible) const;
+    void renderDynamic(RenderQueue &queue, const sf::Rect<float> &visible) const;
+    // Appends the bounds of walls overlapping 'area', found through the BVH
+    // (so a few just outside may be included)
+    void queryWalls(const sf::Rect<float> &area, std::vector<sf::Rect<float>> &out) const;
+
+    const Level &getLevel() const { return *level; }
+    bool isStreaming() const { return streamer != nullptr; }
+    std::uint32_t getTick() const { return tick; }
+    std::uint64_t checksum() const;
+
+    // Captures everything checksum() covers, plus render-only state such as
+    // colours. Restoring reuses existing objects where the counts allow and
+    // fails if the snapshot was taken on a different level. Streamed worlds
+    // cannot be restored (chunk residency is not part of the snapshot).
+    void saveSnapshot(WorldSnapshot &out) const;
+    bool loadSnapshot(const WorldSnapshot &in);
+
+    Player &getPlayer() { return *player; }
+    const Player &getPlayer() const { return *player; }
+    const std::vector<std::unique_ptr<Enemy>> &getEnemies() const { return enemies; }
+    const std::vector<std::unique_ptr<Projectile>> &getProjectiles() const { return projectiles; }
+    const std::vector<Wall> &getWalls() const { return walls; }
+    const std::vector<DestructibleObject> &getDestructibles() const { return destructibles; }
+    const std::vector<WorldEvent> &getEvents() const { return events; }
+    const std::vector<sf::Rect<float>> &getStaticChanges() const { return staticChanges; }
+    const std::vector<std::uint32_t> &getDestructibleChanges() const { return destructibleChanges; }
+    std::uint32_t getStaticGeneration() const { return staticGeneration; }
+};
@@ -0,0 +1,53 @@
+// assetpack.cpp - Packs loose asset files into one archive for the game
+#include "AssetArchive.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+static bool isPrecompressed(const std::filesystem::path &path)
+{
+    std::string ext = path.extension().string();
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".ogg" ||
+           ext == ".mp3" || ext == ".flac" || ext == ".gz";
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " OUTPUT.pak ROOT_DIR [--no-lz4]\n"
+                  << "Entries are named by their path relative to ROOT_DIR, with '/' separators\n";
+        return 1;
+    }
+
+    std::filesystem::path root = argv[2];
+    bool allowLz4 = !(argc > 3 && std::string(argv[3]) == "--no-lz4");
+
+    AssetArchiveWriter writer;
+    std::size_t count = 0;
+    std::error_code error;
+    for (const auto &item : std::filesystem::recursive_directory_iterator(root, error))
+    {
+        if (!item.is_regular_file())
+            continue;
+
+        std::ifstream file(item.path(), std::ios::binary);
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::string name = std::filesystem::relative(item.path(), root).generic_string();
+
+        writer.add(name, std::move(bytes), allowLz4 && !isPrecompressed(item.path()));
+        ++count;
+    }
+    if (error)
+    {
+        std::cerr << "Cannot read " << root << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    if (!writer.writeFile(argv[1]))
+        return 1;
+    std::cout << "Packed " << count << " files into " << argv[1] << "\n";
+    return 0;
+}
@@ -0,0 +1,31 @@
+// levelc.cpp - Offline level compiler: text source -> binary level
+#include "LevelCompiler.h"
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " SOURCE.txt [OUTPUT.lvl]\n"
+                  << "Without OUTPUT, refreshes the cache the game uses (SOURCE.txt.HASH.cache.lvl)\n";
+        return 1;
+    }
+
+    std::string source = argv[1];
+    std::string output;
+    if (argc == 3)
+    {
+        output = argv[2];
+        if (!compileLevelFile(source, output))
+            return 1;
+    }
+    else
+    {
+        output = refreshLevelCache(source);
+        if (output.empty())
+            return 1;
+    }
+
+    std::cout << source << " -> " << output << "\n";
+    return 0;
+}
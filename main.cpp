@@ -1,8 +1,27 @@
 #include "Game.h"
+#include "InputLog.h"
+#include "Options.h"
+#include "RenderBench.h"
+#include "Server.h"
 
-int main()
+int main(int argc, char **argv)
 {
-    Game game;
+    GameOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    if (options.loadTestMatches > 0)
+        return runLoadTest(options);
+    if (options.serverMatches > 0)
+        return runServer(options);
+    if (options.soakClients > 0)
+        return runSoakTest(options);
+    if (!options.replayPath.empty())
+        return runReplay(options);
+    if (options.renderBenchFrames > 0)
+        return runRenderBenchmark(options);
+
+    Game game(options);
     game.run();
     return 0;
-}
\ No newline at end of file
+}